@@ -0,0 +1,311 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BAND_STATISTICS_HPP__
+#define __BAND_STATISTICS_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <gdal.h>
+
+/*
+ * Running statistics over the valid pixels of a band: minimum,
+ * maximum, count, mean and variance, a histogram binned exactly as
+ * GDALGetRasterHistogramEx bins it (optional), and a quantile sketch
+ * (optional).  Pixels equal to the NODATA value and NaNs are skipped.
+ * Accumulators for disjoint parts of a band can be filled
+ * independently (on different threads) and merged.
+ *
+ * The quantile sketch is a log-linear histogram: a value is bucketed
+ * by the top 16 bits of an order-preserving encoding of it as a
+ * float, i.e. by its sign, exponent and top 7 bits of mantissa.  So
+ * it has a fixed size (512 KiB), merges exactly, and estimates each
+ * quantile to within a relative error of 2^-7 (exactly for integers
+ * of magnitude below 256).
+ */
+class band_accumulator
+{
+public:
+    /*
+     * Constructor
+     *
+     * @param lower The lower bound of the histogram
+     * @param upper The upper bound of the histogram
+     * @param num_buckets The number of histogram buckets (zero for no histogram)
+     * @param include_out_of_range Whether to count out of range values
+     *                             in the first/last buckets
+     * @param quantiles Whether to keep a quantile sketch
+     */
+    explicit band_accumulator(double lower = 0, double upper = 0, int num_buckets = 0,
+                              bool include_out_of_range = false, bool quantiles = false)
+        : m_has_nodata(false),
+          m_nodata(0),
+          m_lower(lower),
+          m_scale(num_buckets > 0 ? num_buckets / (upper - lower) : 0),
+          m_include_out_of_range(include_out_of_range),
+          m_histogram(num_buckets > 0 ? num_buckets : 0, 0),
+          m_sketch(quantiles ? SKETCH_SIZE : 0, 0),
+          m_minimum(std::numeric_limits<double>::infinity()),
+          m_maximum(-std::numeric_limits<double>::infinity()),
+          m_count(0),
+          m_mean(0),
+          m_m2(0)
+    {
+    }
+
+    /*
+     * Set the NODATA value (pixels with this value are skipped).
+     *
+     * @param has_nodata Whether the band has a NODATA value
+     * @param nodata The NODATA value
+     */
+    void set_nodata(bool has_nodata, double nodata)
+    {
+        m_has_nodata = has_nodata;
+        m_nodata = nodata;
+    }
+
+    /*
+     * Add pixels to the totals.
+     *
+     * @param pixels The pixel values
+     * @param n The number of pixels
+     */
+    void add(const double *pixels, size_t n)
+    {
+        const int num_buckets = static_cast<int>(m_histogram.size());
+        GUIntBig *histogram = m_histogram.data();
+        GUIntBig *sketch = m_sketch.empty() ? nullptr : m_sketch.data();
+        double minimum = m_minimum;
+        double maximum = m_maximum;
+        double sum = 0;
+        uint64_t count = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double value = pixels[i];
+            if (!valid(value))
+            {
+                continue;
+            }
+            ++count;
+            sum += value;
+            minimum = (value < minimum) ? value : minimum;
+            maximum = (value > maximum) ? value : maximum;
+
+            if (num_buckets > 0)
+            {
+                const double index = std::floor((value - m_lower) * m_scale);
+                if (index < 0)
+                {
+                    if (m_include_out_of_range)
+                    {
+                        ++histogram[0];
+                    }
+                }
+                else if (index >= num_buckets)
+                {
+                    if (m_include_out_of_range)
+                    {
+                        ++histogram[num_buckets - 1];
+                    }
+                }
+                else
+                {
+                    ++histogram[static_cast<int>(index)];
+                }
+            }
+            if (sketch != nullptr)
+            {
+                ++sketch[key(value) >> 16];
+            }
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Two passes over this batch, then the parallel update of Chan et al.
+        const double mean = sum / count;
+        double m2 = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double value = pixels[i];
+            if (valid(value))
+            {
+                m2 += (value - mean) * (value - mean);
+            }
+        }
+
+        m_minimum = minimum;
+        m_maximum = maximum;
+        combine(count, mean, m2);
+    }
+
+    /*
+     * Add the totals of another accumulator (constructed with the same
+     * arguments) to these.
+     *
+     * @param rhs The other accumulator
+     */
+    void merge(const band_accumulator &rhs)
+    {
+        for (size_t i = 0; i < m_histogram.size() && i < rhs.m_histogram.size(); ++i)
+        {
+            m_histogram[i] += rhs.m_histogram[i];
+        }
+        for (size_t i = 0; i < m_sketch.size() && i < rhs.m_sketch.size(); ++i)
+        {
+            m_sketch[i] += rhs.m_sketch[i];
+        }
+        m_minimum = std::min(m_minimum, rhs.m_minimum);
+        m_maximum = std::max(m_maximum, rhs.m_maximum);
+        if (rhs.m_count > 0)
+        {
+            combine(rhs.m_count, rhs.m_mean, rhs.m_m2);
+        }
+    }
+
+    /*
+     * The number of valid pixels seen.
+     */
+    uint64_t count() const
+    {
+        return m_count;
+    }
+
+    double minimum() const
+    {
+        return m_minimum;
+    }
+
+    double maximum() const
+    {
+        return m_maximum;
+    }
+
+    double mean() const
+    {
+        return (m_count > 0) ? m_mean : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /*
+     * The population variance of the valid pixels.
+     */
+    double variance() const
+    {
+        return (m_count > 0) ? m_m2 / m_count : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const std::vector<GUIntBig> &histogram() const
+    {
+        return m_histogram;
+    }
+
+    /*
+     * Estimate a percentile (nearest rank) from the quantile sketch.
+     *
+     * @param percentile The percentile, from 0 to 100
+     * @return The estimate, or NaN if there is no sketch, no valid
+     *         pixel, or the percentile is out of range
+     */
+    double percentile(double percentile) const
+    {
+        if (m_sketch.empty() || m_count == 0 || !(percentile >= 0 && percentile <= 100))
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        else if (percentile == 0)
+        {
+            return m_minimum;
+        }
+        else if (percentile == 100)
+        {
+            return m_maximum;
+        }
+
+        auto rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count));
+        rank = std::max(rank, static_cast<uint64_t>(1));
+        uint64_t seen = 0;
+        for (uint32_t bucket = 0; bucket < SKETCH_SIZE; ++bucket)
+        {
+            seen += m_sketch[bucket];
+            if (seen >= rank)
+            {
+                // The end of the bucket nearer to zero
+                const bool negative = (bucket < (SKETCH_SIZE >> 1));
+                const double value = unkey((bucket << 16) | (negative ? 0xffff : 0));
+                return std::min(std::max(value, m_minimum), m_maximum);
+            }
+        }
+        return m_maximum;
+    }
+
+private:
+    static constexpr uint32_t SKETCH_SIZE = 1 << 16;
+
+    bool valid(double value) const
+    {
+        return !std::isnan(value) && !(m_has_nodata && value == m_nodata);
+    }
+
+    void combine(uint64_t count, double mean, double m2)
+    {
+        const uint64_t total = m_count + count;
+        const double delta = mean - m_mean;
+        m_mean += delta * count / total;
+        m_m2 += m2 + delta * delta * (static_cast<double>(m_count) * count / total);
+        m_count = total;
+    }
+
+    /* An unsigned encoding of a float that preserves its order */
+    static uint32_t key(double value)
+    {
+        float f = static_cast<float>(value);
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+    }
+
+    static double unkey(uint32_t key)
+    {
+        uint32_t bits = (key & 0x80000000) ? (key & 0x7fffffff) : ~key;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    bool m_has_nodata;
+    double m_nodata;
+    double m_lower;
+    double m_scale;
+    bool m_include_out_of_range;
+    std::vector<GUIntBig> m_histogram;
+    std::vector<GUIntBig> m_sketch;
+    double m_minimum;
+    double m_maximum;
+    uint64_t m_count;
+    double m_mean;
+    double m_m2;
+};
+
+#endif
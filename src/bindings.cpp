@@ -14,13 +14,20 @@
  * limitations under the License.
  */
 
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 #if defined(__linux__) || defined(__APPLE__)
 #include <csignal>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <ctime>
+#include <limits>
+#include <memory>
 #include <exception>
 #include <string>
 #include <vector>
@@ -30,6 +37,7 @@
 
 #include <pthread.h>
 
+#include <cpl_vsi.h>
 #include <gdal.h>
 
 #include "bindings.h"
@@ -38,12 +46,36 @@
 #include "locked_dataset.hpp"
 #include "tokens.hpp"
 #include "errorcodes.hpp"
+#include "worker_pool.hpp"
+#include "completion_queue.hpp"
+#include "buffer_pool.hpp"
+#include "transformer_cache.hpp"
+#include "band_statistics.hpp"
+#include "stats_cache.hpp"
+#include "deadline.hpp"
 
 static uint64_t default_nanos = 0;
 
 typedef flat_lru_cache cache_t;
 static cache_t *cache = nullptr;
 
+static int num_threads = 0;
+static worker_pool *pool = nullptr;
+
+static size_t buffer_pool_bytes = 256 * (1 << 20);
+static bool buffer_pool_hugepages = false;
+static buffer_pool *buffers = nullptr;
+
+static completion_queue *completions = nullptr;
+static std::atomic<int64_t> next_request_id(1);
+static std::atomic<bool> requests_stopping(false);
+
+static size_t num_transformers = 64;
+static transformer_cache *transformers = nullptr;
+
+static std::string stats_directory;
+static stats_cache *stats = nullptr;
+
 #if defined(__linux__) || defined(__APPLE__)
 static struct sigaction sa_old, sa_new;
 static bool handler_installed = false;
@@ -59,17 +91,6 @@ static void sigterm_handler(int signal)
 }
 #endif
 
-static uint64_t get_nanos()
-{
-#if defined(__linux__)
-    timespec ts;
-    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
-    return (((uint64_t)ts.tv_sec) * 1000000000) + ts.tv_nsec;
-#else
-    return 0;
-#endif
-}
-
 /**
  * A macro for making one attempt to perform the given operation on
  * (one of) the locked datasets.  If an attempt succeeds, then the
@@ -101,6 +122,12 @@ static uint64_t get_nanos()
  * return the negative of some CPLErrorNum (see
  * https://gdal.org/doxygen/cpl__error_8h.html).
  *
+ * The variable `nanos` is the time budget of the call.  It is checked
+ * before each attempt and, through a deadline for the current thread
+ * (see deadline.hpp), inside GDAL while datasets are opened and read.
+ * A `nanos` of zero leaves the reads themselves unbounded and only
+ * limits the attempts to default_nanos, as it always has.
+ *
  * @param fn The operation to perform
  */
 #define DOIT(fn)                                                                          \
@@ -108,16 +135,18 @@ static uint64_t get_nanos()
     auto query_result = query_token(token);                                               \
     int code = CPLE_None;                                                                 \
     uint64_t then, now;                                                                   \
+    const uint64_t budget = (nanos > 0) ? nanos : default_nanos;                          \
     if (query_result)                                                                     \
     {                                                                                     \
         auto uri_options = query_result.get();                                            \
         then = get_nanos();                                                               \
+        deadline_scope deadline((nanos > 0 && then > 0) ? then + nanos : 0);              \
         int touched = 0;                                                                  \
         int i;                                                                            \
         for (i = 0; (i < attempts || attempts <= 0) && !done; ++i)                        \
         {                                                                                 \
             now = get_nanos();                                                            \
-            if ((nanos > 0) && (now - then > nanos))                                      \
+            if ((budget > 0) && (now - then > budget))                                    \
             {                                                                             \
                 return -CPLE_FileIO;                                                      \
             }                                                                             \
@@ -130,7 +159,7 @@ static uint64_t get_nanos()
             TRY(fn)                                                                       \
             if (!done)                                                                    \
             {                                                                             \
-                sched_yield();                                                          \
+                sched_yield();                                                            \
             }                                                                             \
         }                                                                                 \
         if ((code == ATTEMPT_SUCCESSFUL) && ((i < attempts) || (i > 0 && attempts == 0))) \
@@ -171,6 +200,36 @@ void env_init(size_t *size)
     default_nanos = 0;
 #endif
 
+    env_ptr = getenv("GDALWARP_NUM_THREADS");
+    if (env_ptr != nullptr)
+    {
+        sscanf(env_ptr, "%d", &num_threads);
+    }
+    else
+    {
+#if defined(_SC_NPROCESSORS_ONLN)
+        num_threads = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#else
+        num_threads = 4;
+#endif
+    }
+
+    env_ptr = getenv("GDALWARP_NUM_TRANSFORMERS");
+    if (env_ptr != nullptr)
+    {
+        sscanf(env_ptr, "%zu", &num_transformers);
+    }
+
+    env_ptr = getenv("GDALWARP_BUFFER_POOL_BYTES");
+    if (env_ptr != nullptr)
+    {
+        sscanf(env_ptr, "%zu", &buffer_pool_bytes);
+    }
+    buffer_pool_hugepages = (getenv("GDALWARP_BUFFER_POOL_HUGEPAGES") != nullptr);
+
+    env_ptr = getenv("GDALWARP_STATS_CACHE_DIR");
+    stats_directory = std::string(env_ptr != nullptr ? env_ptr : "");
+
     env_ptr = getenv("GDALWARP_NUM_DATASETS");
     if (env_ptr != nullptr)
     {
@@ -240,6 +299,130 @@ void cache_deinit()
     }
 }
 
+/**
+ * Initialize the pool of worker threads used by calls that touch
+ * several datasets at once.
+ *
+ * @param threads The number of worker threads
+ */
+void pool_init(int threads)
+{
+    pool = new worker_pool{std::max(threads, 0)};
+}
+
+/**
+ * Deinitialize the pool of worker threads.
+ */
+void pool_deinit()
+{
+    if (pool != nullptr)
+    {
+        delete pool;
+        pool = nullptr;
+    }
+}
+
+/**
+ * Initialize the pool of reusable read buffers.
+ *
+ * @param capacity The maximum number of idle bytes to keep
+ * @param hugepages Whether to back large buffers with huge pages
+ */
+void buffers_init(size_t capacity, bool hugepages)
+{
+    buffers = new buffer_pool{capacity, hugepages};
+}
+
+/**
+ * Deinitialize the pool of reusable read buffers.  Buffers that are
+ * still checked out remain valid (and are never freed).
+ */
+void buffers_deinit()
+{
+    if (buffers != nullptr)
+    {
+        delete buffers;
+        buffers = nullptr;
+    }
+}
+
+/**
+ * Initialize (or reopen) the queue of finished asynchronous reads.
+ */
+void completions_init()
+{
+    if (completions == nullptr)
+    {
+        completions = new completion_queue{};
+    }
+    completions->set_closed(false);
+    requests_stopping = false;
+}
+
+/**
+ * Deinitialize the queue of finished asynchronous reads.  The queue
+ * is closed rather than freed: results that were not yet polled
+ * (including those of the reads that deinit cut short) can still be
+ * taken, after which poll_completions reports the shutdown, and a
+ * thread that is waiting in poll_completions is not left holding a
+ * dangling queue.
+ */
+void completions_deinit()
+{
+    if (completions != nullptr)
+    {
+        completions->set_closed(true);
+    }
+}
+
+/**
+ * Initialize the process-wide cache of coordinate transformations.
+ *
+ * @param size The maximum number of idle transformation pairs
+ */
+void transformers_init(size_t size)
+{
+    transformers = new transformer_cache{size};
+}
+
+/**
+ * Deinitialize the cache of coordinate transformations.
+ */
+void transformers_deinit()
+{
+    if (transformers != nullptr)
+    {
+        delete transformers;
+        transformers = nullptr;
+    }
+}
+
+/**
+ * Initialize the persistent statistics cache.
+ *
+ * @param directory The directory to keep statistics in (if empty,
+ *                  statistics are not cached)
+ */
+void stats_init(const std::string &directory)
+{
+    if (!directory.empty())
+    {
+        stats = new stats_cache{directory};
+    }
+}
+
+/**
+ * Deinitialize the persistent statistics cache.
+ */
+void stats_deinit()
+{
+    if (stats != nullptr)
+    {
+        delete stats;
+        stats = nullptr;
+    }
+}
+
 /**
  * The initialization function for the library.
  *
@@ -254,6 +437,11 @@ void init(size_t size)
     errno_init();
     env_init(&size);
     cache_init(size);
+    completions_init();
+    buffers_init(buffer_pool_bytes, buffer_pool_hugepages);
+    pool_init(num_threads);
+    transformers_init(num_transformers);
+    stats_init(stats_directory);
     token_init(640 * (1 << 10));
 
     return;
@@ -264,9 +452,15 @@ void init(size_t size)
  */
 void deinit()
 {
+    requests_stopping = true; // pending asynchronous reads finish with -CPLE_UserInterrupt
+    pool_deinit();            // drain background work before tearing anything else down
+    completions_deinit();
+    buffers_deinit();
     errno_deinit();
     env_deinit();
     cache_deinit();
+    transformers_deinit();
+    stats_deinit();
     token_deinit();
     GDALDestroyDriverManager();
 }
@@ -287,11 +481,11 @@ void __attribute__((destructor)) fini(void)
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int noop(uint64_t token, int dataset, int attempts, int copies)
+int noop(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies)
 {
-    uint64_t nanos = default_nanos;
     DOIT(noop());
 }
 
@@ -303,19 +497,237 @@ int noop(uint64_t token, int dataset, int attempts, int copies)
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band in question
  * @param width The return-location of the block width
  * @param height The return-location of the block height
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_block_size(uint64_t token, int dataset, int attempts, int copies,
+int get_block_size(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                    int band_number, int *width, int *height)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_block_size(dataset, band_number, width, height));
 }
 
+/**
+ * Get the block size of an overview of the given band (see
+ * get_block_size).
+ */
+static int get_overview_block_size(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                                   int band_number, int overview, int *width, int *height)
+{
+    DOIT(get_overview_block_size(dataset, band_number, overview, width, height));
+}
+
+/**
+ * Find the key and validator under which a statistic of a band is
+ * kept in the persistent statistics cache.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param band_number The band in question
+ * @param what The statistic and its parameters
+ * @param key The return-location of the key
+ * @param validator The return-location of the validator
+ * @return True if the statistic can be cached
+ */
+static bool stats_key(uint64_t token, int dataset, int band_number, const std::string &what,
+                      std::string *key, std::string *validator)
+{
+    if (stats == nullptr)
+    {
+        return false;
+    }
+    auto query_result = query_token(token);
+    if (!query_result)
+    {
+        return false;
+    }
+    auto uri_options = query_result.get();
+    if (!stats_cache::validator(uri_options.first, validator))
+    {
+        return false;
+    }
+
+    *key = what + "\t" + std::to_string(dataset) + "\t" + std::to_string(band_number) + "\t" + uri_options.first;
+    for (const auto &option : uri_options.second)
+    {
+        *key += "\t" + option;
+    }
+    return true;
+}
+
+/**
+ * Scan a band, reading block-aligned chunks of it concurrently on the
+ * worker pool (spread over the copies of the dataset) and
+ * accumulating statistics over their valid pixels.  Chunks are
+ * aligned to the blocks of the level being scanned, hold about 4 MiB
+ * of pixels, and are read in the band's own type (then converted to
+ * double a slice at a time).  The lock of a dataset is held only while
+ * a chunk is read from it, not while the chunk is accumulated.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for the whole scan (in
+ *              nanoseconds, zero for none); each chunk gets what
+ *              remains of it
+ * @param copies The desired number of datasets
+ * @param band_number The band in question
+ * @param overview The overview to scan (-1 for full resolution)
+ * @param sample If positive, read only about this many pixels, in
+ *               whole blocks spread evenly over the level, instead of
+ *               the whole level
+ * @param accumulator An empty accumulator on entry (its NODATA value
+ *                    is set here), the totals on return
+ * @return The number of attempts on success, negative CPLErrorNum on
+ *         failure (-CPLE_NotSupported for complex bands)
+ */
+static int scan_band(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                     int band_number, int overview, int64_t sample, band_accumulator *accumulator)
+{
+    int width, height, block_width, block_height, data_type, has_nodata, code;
+    double nodata;
+#if !defined(__linux__)
+    nanos = 0;
+#endif
+    const uint64_t deadline = deadline_after(nanos);
+
+    if ((code = get_band_data_type(token, dataset, attempts, nanos_until(deadline), copies, band_number, &data_type)) < 0 ||
+        (code = get_width_height(token, dataset, attempts, nanos_until(deadline), copies, &width, &height)) < 0 ||
+        (code = get_block_size(token, dataset, attempts, nanos_until(deadline), copies, band_number, &block_width, &block_height)) < 0 ||
+        (code = get_band_nodata(token, dataset, attempts, nanos_until(deadline), copies, band_number, &nodata, &has_nodata)) < 0)
+    {
+        return code;
+    }
+    const auto native = static_cast<GDALDataType>(data_type);
+    const int pixel_size = GDALGetDataTypeSizeBytes(native);
+    if (GDALDataTypeIsComplex(native) || pixel_size <= 0)
+    {
+        return -CPLE_NotSupported;
+    }
+    if (overview >= 0)
+    {
+        auto widths = std::vector<int>(overview + 1);
+        auto heights = std::vector<int>(overview + 1);
+        if ((code = get_overview_widths_heights(token, dataset, attempts, nanos_until(deadline), copies, band_number,
+                                                widths.data(), heights.data(), overview + 1)) < 0)
+        {
+            return code;
+        }
+        if (widths[overview] <= 0 || heights[overview] <= 0)
+        {
+            return -CPLE_IllegalArg;
+        }
+        width = widths[overview];
+        height = heights[overview];
+        if ((code = get_overview_block_size(token, dataset, attempts, nanos_until(deadline), copies, band_number, overview,
+                                            &block_width, &block_height)) < 0)
+        {
+            return code;
+        }
+    }
+    block_width = std::max(block_width, 1);
+    block_height = std::max(block_height, 1);
+
+    // Compare against the NODATA value as the band stores it
+    if (has_nodata)
+    {
+        uint8_t stored[16];
+        GDALCopyWords(&nodata, GDT_Float64, 0, stored, native, 0, 1);
+        GDALCopyWords(stored, native, 0, &nodata, GDT_Float64, 0, 1);
+    }
+    accumulator->set_nodata(has_nodata, nodata);
+    const band_accumulator empty = *accumulator;
+
+    // Chunks of about 4 MiB on block boundaries, or every so many
+    // blocks across and down when only a sample is wanted
+    int chunk_width, chunk_height, step_x = 1, step_y = 1;
+    if (sample > 0)
+    {
+        chunk_width = std::min(width, block_width);
+        chunk_height = std::min(height, block_height);
+        const double ratio = static_cast<double>(width) * height / sample;
+        if (ratio > 1)
+        {
+            const int across = (width + chunk_width - 1) / chunk_width;
+            step_x = std::min(across, static_cast<int>(std::ceil(std::sqrt(ratio))));
+            step_y = static_cast<int>(std::ceil(ratio / step_x));
+        }
+    }
+    else
+    {
+        const int chunk_pixels = (1 << 22) / pixel_size;
+        chunk_width = std::min(width, std::max(block_width, (2048 / block_width) * block_width));
+        chunk_height = std::min(height, std::max(block_height, (chunk_pixels / chunk_width / block_height) * block_height));
+    }
+
+    // Each chunk is merged into the totals as soon as it is done
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    int touched = 0;
+    code = 0;
+    {
+        task_group group;
+        for (int64_t y = 0; y < height; y += static_cast<int64_t>(chunk_height) * step_y)
+        {
+            for (int64_t x = 0; x < width; x += static_cast<int64_t>(chunk_width) * step_x)
+            {
+                group.run(pool, [=, &lock, &touched, &code]() {
+                    int src_window[4] = {static_cast<int>(x), static_cast<int>(y),
+                                         std::min(chunk_width, static_cast<int>(width - x)),
+                                         std::min(chunk_height, static_cast<int>(height - y))};
+                    int dst_window[2] = {src_window[2], src_window[3]};
+                    const size_t count = static_cast<size_t>(dst_window[0]) * dst_window[1];
+                    auto pixels = std::vector<uint8_t>(count * pixel_size);
+                    auto partial = empty;
+                    read_options_t options;
+
+                    INIT_READ_OPTIONS(options);
+                    options.band_count = 1;
+                    options.band_list = &band_number;
+                    options.overview = overview;
+                    int retval = deadline_passed(deadline)
+                                     ? -CPLE_FileIO
+                                     : get_data_ex(token, dataset, attempts, nanos_until(deadline), copies,
+                                                   src_window, dst_window, data_type, pixels.data(), &options);
+                    for (size_t i = 0; retval > 0 && i < count; i += 1024)
+                    {
+                        double values[1024];
+                        const int n = static_cast<int>(std::min(count - i, static_cast<size_t>(1024)));
+                        GDALCopyWords(pixels.data() + i * pixel_size, native, pixel_size, values, GDT_Float64, sizeof(double), n);
+                        partial.add(values, n);
+                    }
+
+                    pthread_mutex_lock(&lock);
+                    if (retval < 0)
+                    {
+                        code = (code < 0) ? code : retval;
+                    }
+                    else
+                    {
+                        touched += retval;
+                        accumulator->merge(partial);
+                    }
+                    pthread_mutex_unlock(&lock);
+                });
+            }
+        }
+        group.wait();
+    }
+    pthread_mutex_destroy(&lock);
+
+    return (code < 0) ? code : touched;
+}
+
+static int compute_histogram(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                             int band_number, double lower, double upper, int num_buckets,
+                             GUIntBig *hist, int include_out_of_range, int approx_ok);
+
 /** Get the histogram of a given band
  *
  * @param token A token associated with some uri ⨯ options pair
@@ -323,6 +735,7 @@ int get_block_size(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band in question
  * @param lower the lower bound of the histogram
@@ -331,12 +744,54 @@ int get_block_size(uint64_t token, int dataset, int attempts, int copies,
  * @param hist array into which the histogram totals are placed
  * @param include_out_of_range Whether to map out of range values into the first/last buckets
  * @param approx_ok Whether to accept an approximate histogram. With COGs, will cause the use of overviews
+ *                  (exact histograms are computed by scan_band)
  */
-int get_histogram(uint64_t token, int dataset, int attempts, int copies,
+int get_histogram(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                   int band_number, double lower, double upper, int num_buckets,
                   GUIntBig *hist, int include_out_of_range, int approx_ok)
 {
-    uint64_t nanos = default_nanos;
+    std::string key, validator;
+    auto values = std::vector<double>();
+    bool cacheable = (num_buckets > 0) &&
+                     stats_key(token, dataset, band_number,
+                               CPLSPrintf("histogram %.17g %.17g %d %d %d", lower, upper, num_buckets,
+                                          include_out_of_range != 0, approx_ok != 0),
+                               &key, &validator);
+
+    if (cacheable && stats->get(key, validator, &values) && values.size() == static_cast<size_t>(num_buckets))
+    {
+        std::copy(values.begin(), values.end(), hist);
+        return 1;
+    }
+    int code = compute_histogram(token, dataset, attempts, nanos, copies, band_number,
+                                 lower, upper, num_buckets, hist, include_out_of_range, approx_ok);
+    if (cacheable && code > 0)
+    {
+        stats->put(key, validator, std::vector<double>(hist, hist + num_buckets));
+    }
+    return code;
+}
+
+/**
+ * Compute the histogram of a given band (see get_histogram).
+ */
+static int compute_histogram(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                             int band_number, double lower, double upper, int num_buckets,
+                             GUIntBig *hist, int include_out_of_range, int approx_ok)
+{
+    if (!approx_ok && num_buckets > 0 && upper > lower)
+    {
+        auto accumulator = band_accumulator(lower, upper, num_buckets, include_out_of_range);
+        int code = scan_band(token, dataset, attempts, nanos, copies, band_number, -1, 0, &accumulator);
+        if (code != -CPLE_NotSupported)
+        {
+            if (code > 0)
+            {
+                std::copy(accumulator.histogram().begin(), accumulator.histogram().end(), hist);
+            }
+            return code;
+        }
+    }
     DOIT(get_histogram(dataset, band_number,
                        lower, upper, num_buckets, hist, include_out_of_range, approx_ok));
 }
@@ -349,16 +804,16 @@ int get_histogram(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band in question
  * @param offset The return-location of the offset
  * @param success The return-location of the success flag
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_offset(uint64_t token, int dataset, int attempts, int copies,
+int get_offset(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                int band_number, double *offset, int *success)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_offset(dataset, band_number, offset, success));
 }
 
@@ -370,16 +825,16 @@ int get_offset(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band in question
  * @param scale The return-location of the scale
  * @param success The return-location of the success flag
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_scale(uint64_t token, int dataset, int attempts, int copies,
+int get_scale(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
               int band_number, double *scale, int *success)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_scale(dataset, band_number, scale, success));
 }
 
@@ -391,16 +846,16 @@ int get_scale(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band in question
  * @param color_interp The return-slot for the integer-coded color
  *                     interpretation
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_color_interpretation(uint64_t token, int dataset, int attempts, int copies,
+int get_color_interpretation(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                              int band_number, int *color_interp)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_color_interpretation(dataset, band_number, color_interp));
 }
 
@@ -412,15 +867,15 @@ int get_color_interpretation(uint64_t token, int dataset, int attempts, int copi
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band to query (zero for the file itself)
  * @param domain_list The return-location for the list of strings
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_metadata_domain_list(uint64_t token, int dataset, int attempts, int copies,
+int get_metadata_domain_list(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                              int band_number, char ***domain_list)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_metadata_domain_list(dataset, band_number, domain_list));
 }
 
@@ -432,16 +887,16 @@ int get_metadata_domain_list(uint64_t token, int dataset, int attempts, int copi
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band to query (zero for the file itself)
  * @param domain The metadata domain to query
  * @param list The return-location for the list of strings
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_metadata(uint64_t token, int dataset, int attempts, int copies,
+int get_metadata(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                  int band_number, const char *domain, char ***list)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_metadata(dataset, band_number, domain, list));
 }
 
@@ -453,6 +908,7 @@ int get_metadata(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band to query (zero for the file itself)
  * @param key The key of the key ⨯ value metadata pair
@@ -460,10 +916,9 @@ int get_metadata(uint64_t token, int dataset, int attempts, int copies,
  * @param value The return-location for the value of the key ⨯ value pair
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_metadata_item(uint64_t token, int dataset, int attempts, int copies,
+int get_metadata_item(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                       int band_number, const char *key, const char *domain, const char **value)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_metadata_item(dataset, band_number, key, domain, value));
 }
 
@@ -475,6 +930,7 @@ int get_metadata_item(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band of interest
  * @param widths An array of integers to receive the widths of the
@@ -486,10 +942,9 @@ int get_metadata_item(uint64_t token, int dataset, int attempts, int copies,
  *                   the two arrays)
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_overview_widths_heights(uint64_t token, int dataset, int attempts, int copies,
+int get_overview_widths_heights(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                                 int band_number, int *widths, int *heights, int max_length)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_overview_widths_heights(dataset, band_number, widths, heights, max_length))
 }
 
@@ -501,15 +956,15 @@ int get_overview_widths_heights(uint64_t token, int dataset, int attempts, int c
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param crs The character array in-which to return the PROJ.4 string
  * @param max_size The size of the pre-allocated return buffer
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_crs_proj4(uint64_t token, int dataset, int attempts, int copies,
+int get_crs_proj4(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                   char *crs, int max_size)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_crs_proj4(dataset, crs, max_size));
 }
 
@@ -522,14 +977,14 @@ int get_crs_proj4(uint64_t token, int dataset, int attempts, int copies,
  *                warped dataset
  * @param copies The desired number of datasets
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param crs The character array in-which to return the PROJ.4 string
  * @param max_size The size of the pre-allocated return buffer
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_crs_wkt(uint64_t token, int dataset, int attempts, int copies,
+int get_crs_wkt(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                 char *crs, int max_size)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_crs_wkt(dataset, crs, max_size))
 }
 
@@ -541,6 +996,7 @@ int get_crs_wkt(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band of interest
  * @param nodata The return-location of the NODATA value
@@ -548,13 +1004,58 @@ int get_crs_wkt(uint64_t token, int dataset, int attempts, int copies,
  *                whether or not there is a NODATA value)
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_band_nodata(uint64_t token, int dataset, int attempts, int copies,
+int get_band_nodata(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                     int band_number, double *nodata, int *success)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_band_nodata(dataset, band_number, nodata, success))
 }
 
+/**
+ * Get the minimum and maximum values of a band from its metadata
+ * (nothing is computed while the dataset is locked).
+ */
+static int get_band_max_min(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                            int band_number, double *minmax, int *success)
+{
+    DOIT(get_band_max_min(dataset, band_number, false, minmax, success));
+}
+
+/**
+ * The number of pixels that approximate statistics are computed from:
+ * the smallest overview with at least this many, or a sample of this
+ * many (see scan_band) if there is none.
+ */
+static constexpr int64_t approximate_pixels = 1 << 20;
+
+/**
+ * Choose the overview to scan when approximate statistics are good
+ * enough: the smallest one with at least approximate_pixels pixels,
+ * or full resolution (to be sampled) if there is none.
+ *
+ * @param overview The return-location of the overview (-1 for full
+ *                 resolution)
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+static int approximate_overview(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                                int band_number, int *overview)
+{
+    constexpr int max_overviews = 32;
+    int widths[max_overviews], heights[max_overviews];
+    int code = get_overview_widths_heights(token, dataset, attempts, nanos, copies, band_number,
+                                           widths, heights, max_overviews);
+    *overview = -1;
+    for (int i = 0; code > 0 && i < max_overviews && widths[i] > 0 && heights[i] > 0; ++i)
+    {
+        int64_t pixels = static_cast<int64_t>(widths[i]) * heights[i];
+        if (pixels >= approximate_pixels &&
+            (*overview < 0 || pixels < static_cast<int64_t>(widths[*overview]) * heights[*overview]))
+        {
+            *overview = i;
+        }
+    }
+    return code;
+}
+
 /**
  * Get the minimum and maximum values found in the band.
  *
@@ -563,61 +1064,212 @@ int get_band_nodata(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band_number of interest
  * @param approx_okay Is it okay to approximate the value if it is not
  *                    stored in the metadata, or must it be calculated
- *                    exactly?  An integer treated as a boolean
+ *                    exactly?  An integer treated as a boolean.  Values
+ *                    that are not in the metadata are computed by
+ *                    scan_band, outside the dataset lock: exactly, or
+ *                    from an overview or a sample of blocks (see
+ *                    get_statistics) if approximation is okay
  * @param minmax The return-location of the minimum and maximum
  * @param success The return-location of the success flag (answer
  *                whether or not there is a NODATA value)
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_band_min_max(uint64_t token, int dataset, int attempts, int copies,
+int get_band_min_max(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                      int band_number, int approx_okay, double *minmax, int *success)
 {
-    uint64_t nanos = default_nanos;
-    DOIT(get_band_max_min(dataset, band_number, approx_okay, minmax, success));
+    std::string key, validator;
+    auto values = std::vector<double>();
+    bool cacheable = stats_key(token, dataset, band_number, CPLSPrintf("minmax %d", approx_okay != 0), &key, &validator);
+
+    if (cacheable && stats->get(key, validator, &values) && values.size() == 3)
+    {
+        minmax[0] = values[0];
+        minmax[1] = values[1];
+        *success = static_cast<int>(values[2]);
+        return 1;
+    }
+
+    // Only the metadata is consulted under the lock
+    int code = get_band_max_min(token, dataset, attempts, nanos, copies, band_number, minmax, success);
+    if (code > 0 && !*success)
+    {
+        // Not in the metadata, so compute it
+        int overview = -1;
+        if (approx_okay)
+        {
+            int found = approximate_overview(token, dataset, attempts, nanos, copies, band_number, &overview);
+            if (found < 0)
+            {
+                return found;
+            }
+            code += found;
+        }
+        auto accumulator = band_accumulator();
+        const int64_t sample = (approx_okay && overview < 0) ? approximate_pixels : 0;
+        int scanned = scan_band(token, dataset, attempts, nanos, copies, band_number, overview, sample, &accumulator);
+        if (scanned == -CPLE_NotSupported)
+        {
+            return code;
+        }
+        else if (scanned < 0)
+        {
+            return scanned;
+        }
+        if (accumulator.count() > 0)
+        {
+            minmax[0] = accumulator.minimum();
+            minmax[1] = accumulator.maximum();
+            *success = true;
+        }
+        code += scanned;
+    }
+    if (cacheable && code > 0)
+    {
+        stats->put(key, validator, {minmax[0], minmax[1], static_cast<double>(*success)});
+    }
+    return code;
 }
 
 /**
- * Get the data type of a given band.
+ * Compute statistics over the valid pixels of a band in one pass
+ * (see scan_band): count, minimum, maximum, mean, population standard
+ * deviation, and approximate percentiles (see band_accumulator).
  *
  * @param token A token associated with some uri ⨯ options pair
  * @param dataset 0 (or locked_dataset::SOURCE) for the source
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param band_number The band of interest
- * @param data_type The return-location of the band_number type (of integral
- *                  type GDALDataType)
+ * @param approx_ok Whether statistics may be computed from an
+ *                  overview (the smallest one with at least 2^20
+ *                  pixels) or, if there is none, from a sample of
+ *                  about 2^20 pixels rather than from every pixel
+ * @param percentile_count The number of percentiles wanted
+ * @param percentiles The percentiles wanted (from 0 to 100)
+ * @param percentile_values The return-location of the percentiles
+ * @param statistics The return-location of the other statistics
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_band_data_type(uint64_t token, int dataset, int attempts, int copies,
-                       int band_number, int *data_type)
+int get_statistics(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                   int band_number, int approx_ok,
+                   int percentile_count,
+                   const double *percentiles,
+                   double *percentile_values,
+                   statistics_t *statistics)
 {
-    uint64_t nanos = default_nanos;
-    auto ptr = reinterpret_cast<GDALDataType *>(data_type);
-    DOIT(get_band_data_type(dataset, band_number, ptr));
-}
+    if (statistics == nullptr || percentile_count < 0 ||
+        (percentile_count > 0 && (percentiles == nullptr || percentile_values == nullptr)))
+    {
+        return -CPLE_IllegalArg;
+    }
 
-/**
- * Get the number of bands.
- *
- * @param token A token associated with some uri ⨯ options pair
- * @param dataset 0 (or locked_dataset::SOURCE) for the source
- *                dataset, 1 (or locked_dataset::WARPED) for the
- *                warped dataset
- * @param attempts The number of attempts to make before giving up
- * @param copies The desired number of datasets
- * @param band_count The return-location of the band count
- * @return The number of attempts on success, negative CPLErrorNum on failure
- */
-int get_band_count(uint64_t token, int dataset, int attempts, int copies,
+    int overview = -1;
+    if (approx_ok)
+    {
+        int code = approximate_overview(token, dataset, attempts, nanos, copies, band_number, &overview);
+        if (code < 0)
+        {
+            return code;
+        }
+    }
+
+    std::string what = CPLSPrintf("statistics %d %d", approx_ok != 0, overview);
+    for (int i = 0; i < percentile_count; ++i)
+    {
+        what += CPLSPrintf(" %.17g", percentiles[i]);
+    }
+    std::string key, validator;
+    auto values = std::vector<double>();
+    bool cacheable = stats_key(token, dataset, band_number, what, &key, &validator);
+
+    if (cacheable && stats->get(key, validator, &values) && values.size() == static_cast<size_t>(5 + percentile_count))
+    {
+        statistics->valid_count = static_cast<int64_t>(values[0]);
+        statistics->minimum = values[1];
+        statistics->maximum = values[2];
+        statistics->mean = values[3];
+        statistics->stddev = values[4];
+        std::copy(values.begin() + 5, values.end(), percentile_values);
+        return 1;
+    }
+
+    auto accumulator = band_accumulator(0, 0, 0, false, percentile_count > 0);
+    const int64_t sample = (approx_ok && overview < 0) ? approximate_pixels : 0;
+    int code = scan_band(token, dataset, attempts, nanos, copies, band_number, overview, sample, &accumulator);
+    if (code < 0)
+    {
+        return code;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const bool any = (accumulator.count() > 0);
+    statistics->valid_count = static_cast<int64_t>(accumulator.count());
+    statistics->minimum = any ? accumulator.minimum() : nan;
+    statistics->maximum = any ? accumulator.maximum() : nan;
+    statistics->mean = accumulator.mean();
+    statistics->stddev = std::sqrt(accumulator.variance());
+    for (int i = 0; i < percentile_count; ++i)
+    {
+        percentile_values[i] = accumulator.percentile(percentiles[i]);
+    }
+
+    if (cacheable)
+    {
+        values = {static_cast<double>(statistics->valid_count), statistics->minimum, statistics->maximum,
+                  statistics->mean, statistics->stddev};
+        values.insert(values.end(), percentile_values, percentile_values + percentile_count);
+        stats->put(key, validator, values);
+    }
+
+    return code;
+}
+
+/**
+ * Get the data type of a given band.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param band_number The band of interest
+ * @param data_type The return-location of the band_number type (of integral
+ *                  type GDALDataType)
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int get_band_data_type(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                       int band_number, int *data_type)
+{
+    auto ptr = reinterpret_cast<GDALDataType *>(data_type);
+    DOIT(get_band_data_type(dataset, band_number, ptr));
+}
+
+/**
+ * Get the number of bands.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param band_count The return-location of the band count
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int get_band_count(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                    int *band_count)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_band_count(dataset, band_count))
 }
 
@@ -629,15 +1281,15 @@ int get_band_count(uint64_t token, int dataset, int attempts, int copies,
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
  * @param width The return-location of the width
  * @param height The return-location of the height
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_width_height(uint64_t token, int dataset, int attempts, int copies,
+int get_width_height(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                      int *width, int *height)
 {
-    uint64_t nanos = default_nanos;
     DOIT(get_width_height(dataset, width, height))
 }
 
@@ -674,21 +1326,1484 @@ int get_data(uint64_t token, int dataset, int attempts, uint64_t nanos, int copi
 }
 
 /**
- * Get the the transform.
+ * Get pixel data from several bands at once.
  *
  * @param token A token associated with some uri ⨯ options pair
  * @param dataset 0 (or locked_dataset::SOURCE) for the source
  *                dataset, 1 (or locked_dataset::WARPED) for the
  *                warped dataset
  * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
  * @param copies The desired number of datasets
- * @param transform The return location for the six double-precision
- *                  floating point number that will be returned
+ * @param src_window Please see https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+ * @param dst_window Please see https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+ * @param _type The desired type of returned pixels (the argument is
+ *              of integral type GDALDataType)
+ * @param data The return-location of the read data
+ * @param options The bands to read, the overview to read from
+ *                (src_window is then in the pixel space of that
+ *                overview), the resampling algorithm, an optional
+ *                fractional source window (which replaces
+ *                src_window), the layout of the returned data,
+ *                either an interleaving or explicit pixel, line and
+ *                band spacing, and an optional return-location for
+ *                the validity mask of the first band, one byte or one
+ *                bit per pixel (NULL for all bands at full
+ *                resolution, nearest neighbour, band-sequential, no
+ *                mask)
  * @return The number of attempts on success, negative CPLErrorNum on failure
  */
-int get_transform(uint64_t token, int dataset, int attempts, int copies,
-                  double transform[6])
+int get_data_ex(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                int src_window[4],
+                int dst_window[2],
+                int _type,
+                void *data,
+                const read_options_t *options)
 {
-    uint64_t nanos = default_nanos;
-    DOIT(get_transform(dataset, transform))
+    auto type = static_cast<GDALDataType>(_type);
+    read_options_t default_options;
+    if (options == nullptr)
+    {
+        INIT_READ_OPTIONS(default_options);
+        options = &default_options;
+    }
+#if !defined(__linux__)
+    nanos = 0;
+#endif
+    DOIT(get_pixels_ex(dataset, src_window, dst_window, type, data, options))
+}
+
+/**
+ * Get pixel data from a batch of windows of one dataset.  The token
+ * is resolved and a dataset is locked once for the whole batch
+ * (rather than once per window), and the windows are read in source
+ * block order for better block-cache and range-request locality.  If
+ * an attempt is interrupted, the next attempt resumes with the first
+ * window that has not yet been read.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param count The number of windows
+ * @param src_windows The source windows, four entries per window (see get_data)
+ * @param dst_windows The destination sizes, two entries per window (see get_data)
+ * @param _type The desired type of returned pixels (the argument is
+ *              of integral type GDALDataType)
+ * @param data The return-locations of the read data (one per window)
+ * @param options The bands to read, resampling, and the layout of
+ *                the returned data, shared by all windows (NULL for
+ *                all bands, band-sequential); fractional windows and
+ *                masks are not supported
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int get_data_batch(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                   int count,
+                   const int *src_windows,
+                   const int *dst_windows,
+                   int _type,
+                   void *const *data,
+                   const read_options_t *options)
+{
+    auto type = static_cast<GDALDataType>(_type);
+    read_options_t default_options;
+    if (options == nullptr)
+    {
+        INIT_READ_OPTIONS(default_options);
+        options = &default_options;
+    }
+    // A fractional window or a mask describes one window, not a batch
+    if (count < 0 || options->has_fractional_window || options->mask != nullptr)
+    {
+        return -CPLE_IllegalArg;
+    }
+    auto order = std::vector<int>(count);
+    int next = 0;
+#if !defined(__linux__)
+    nanos = 0;
+#endif
+    DOIT(get_pixels_batch(dataset, count, src_windows, dst_windows, type, data, options, order.data(), &next))
+}
+
+/**
+ * Compute the part of a one-dimensional source range (in fractional
+ * source pixels) that corresponds to a given destination range,
+ * clipped to the source.  The range is not rounded to whole pixels,
+ * so neighbouring sources line up exactly in the destination.
+ *
+ * @param from The (fractional) source pixel corresponding to the
+ *             start of the destination range
+ * @param to The (fractional) source pixel corresponding to the end
+ *           of the destination range
+ * @param limit The size of the source
+ * @param offset The return-location of the (fractional) first source pixel
+ * @param length The return-location of the (fractional) number of source pixels
+ * @return Whether the clipped range is non-empty
+ */
+static bool source_range(double from, double to, int limit, double *offset, double *length)
+{
+    if (from > to)
+    {
+        std::swap(from, to);
+    }
+    from = std::max(from, 0.0);
+    to = std::min(to, static_cast<double>(limit));
+    *offset = from;
+    *length = to - from;
+    return *length > 0;
+}
+
+/**
+ * Composite the warped datasets of several tokens into one buffer.
+ * Each token contributes the pixels of its warped dataset that fall
+ * within the destination extent; where contributions overlap, the
+ * first valid pixel (in token order) wins.  Validity is taken from
+ * the first requested band only: a pixel is valid if the mask of that
+ * band (see https://gdal.org/development/rfc/rfc15_nodatabitmask.html)
+ * is set, so NODATA is compared in the source type whatever the
+ * requested type is, and the other bands of a valid pixel are copied
+ * as they are.  Each token is read through the exact fractional
+ * source window that corresponds to its destination pixels (see
+ * read_options_t), so adjacent tokens meet without seams.
+ *
+ * The warped datasets must share the CRS of the destination extent
+ * and have north-up transforms.  The first contributing token is read
+ * straight into its region of the destination buffer; the others are
+ * read concurrently (spread across copies of the datasets) and then
+ * composited.  Pixels that no token covers keep their initial value,
+ * covered pixels that are not valid in any token hold whatever the
+ * first contributing token returned there (normally its NODATA
+ * value).
+ *
+ * @param tokens The tokens, in priority order
+ * @param count The number of tokens
+ * @param attempts The number of attempts to make before giving up
+ *                 (for each token)
+ * @param nanos The approximate time budget for this call (in
+ *              nanoseconds, zero for none); each read gets what
+ *              remains of it
+ * @param copies The desired number of datasets
+ * @param dst_extent The minimum x, minimum y, maximum x and maximum y
+ *                   of the destination
+ * @param dst_size The width and height of the destination buffer
+ * @param _type The desired type of returned pixels (the argument is
+ *              of integral type GDALDataType)
+ * @param data The destination buffer (band-sequential)
+ * @param options The bands to read and the resampling algorithm
+ *                (band_count must be positive, the layout must be
+ *                band-sequential, and the read must be at full
+ *                resolution without a fractional window or mask)
+ * @return The total number of attempts on success (zero if no token
+ *         overlaps the extent), negative CPLErrorNum on failure
+ */
+int get_mosaic(const uint64_t *tokens, int count, int attempts, uint64_t nanos, int copies,
+               const double dst_extent[4],
+               const int dst_size[2],
+               int _type,
+               void *data,
+               const read_options_t *options)
+{
+    struct contribution_t
+    {
+        uint64_t token;
+        int src_window[4];
+        double fractional_window[4];
+        int dst_offset[2];
+        int dst_window[2];
+        std::vector<uint8_t> pixels;
+        std::vector<uint8_t> mask;
+        int code;
+    };
+
+    if (count < 0 || options == nullptr || options->band_count <= 0 ||
+        options->interleave != INTERLEAVE_BAND ||
+        options->pixel_space != 0 || options->line_space != 0 || options->band_space != 0 ||
+        options->overview >= 0 || options->has_fractional_window || options->mask != nullptr ||
+        dst_size[0] <= 0 || dst_size[1] <= 0 ||
+        !(dst_extent[2] > dst_extent[0]) || !(dst_extent[3] > dst_extent[1]))
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    auto type = static_cast<GDALDataType>(_type);
+    const int width = dst_size[0];
+    const int height = dst_size[1];
+    const int band_count = options->band_count;
+    const size_t size = GDALGetDataTypeSizeBytes(type);
+    const size_t band_stride = size * width * height;
+    const double res_x = (dst_extent[2] - dst_extent[0]) / width;
+    const double res_y = (dst_extent[3] - dst_extent[1]) / height;
+    auto bytes = static_cast<uint8_t *>(data);
+#if !defined(__linux__)
+    nanos = 0;
+#endif
+    const uint64_t deadline = deadline_after(nanos);
+
+    // Work out the region of the destination that each token covers
+    auto contributions = std::vector<contribution_t>();
+    for (int i = 0; i < count; ++i)
+    {
+        double transform[6];
+        int src_width, src_height;
+        int code;
+
+        if ((code = get_transform(tokens[i], locked_dataset::WARPED, attempts, nanos_until(deadline), copies, transform)) < 0 ||
+            (code = get_width_height(tokens[i], locked_dataset::WARPED, attempts, nanos_until(deadline), copies, &src_width, &src_height)) < 0)
+        {
+            return code;
+        }
+        if (transform[2] != 0 || transform[4] != 0)
+        {
+            return -CPLE_NotSupported;
+        }
+
+        double x0 = transform[0];
+        double x1 = transform[0] + transform[1] * src_width;
+        double y0 = transform[3];
+        double y1 = transform[3] + transform[5] * src_height;
+        double left = std::max(dst_extent[0], std::min(x0, x1));
+        double right = std::min(dst_extent[2], std::max(x0, x1));
+        double bottom = std::max(dst_extent[1], std::min(y0, y1));
+        double top = std::min(dst_extent[3], std::max(y0, y1));
+        if (!(left < right) || !(bottom < top))
+        {
+            continue;
+        }
+
+        int col0 = std::max(0, static_cast<int>(std::lround((left - dst_extent[0]) / res_x)));
+        int col1 = std::min(width, static_cast<int>(std::lround((right - dst_extent[0]) / res_x)));
+        int row0 = std::max(0, static_cast<int>(std::lround((dst_extent[3] - top) / res_y)));
+        int row1 = std::min(height, static_cast<int>(std::lround((dst_extent[3] - bottom) / res_y)));
+        if (col1 <= col0 || row1 <= row0)
+        {
+            continue;
+        }
+
+        contribution_t c;
+        c.token = tokens[i];
+        c.dst_offset[0] = col0;
+        c.dst_offset[1] = row0;
+        c.dst_window[0] = col1 - col0;
+        c.dst_window[1] = row1 - row0;
+        if (!source_range((dst_extent[0] + col0 * res_x - transform[0]) / transform[1],
+                          (dst_extent[0] + col1 * res_x - transform[0]) / transform[1],
+                          src_width, &c.fractional_window[0], &c.fractional_window[2]) ||
+            !source_range((dst_extent[3] - row0 * res_y - transform[3]) / transform[5],
+                          (dst_extent[3] - row1 * res_y - transform[3]) / transform[5],
+                          src_height, &c.fractional_window[1], &c.fractional_window[3]))
+        {
+            continue;
+        }
+        // The enclosing whole-pixel window (superseded by the fractional one)
+        c.src_window[0] = static_cast<int>(std::floor(c.fractional_window[0]));
+        c.src_window[1] = static_cast<int>(std::floor(c.fractional_window[1]));
+        c.src_window[2] = static_cast<int>(std::ceil(c.fractional_window[0] + c.fractional_window[2])) - c.src_window[0];
+        c.src_window[3] = static_cast<int>(std::ceil(c.fractional_window[1] + c.fractional_window[3])) - c.src_window[1];
+        c.code = 0;
+        contributions.push_back(std::move(c));
+    }
+
+    // Read the contributions concurrently
+    {
+        task_group group;
+        for (size_t i = 0; i < contributions.size(); ++i)
+        {
+            auto c = &contributions[i];
+            group.run(pool, [=]() {
+                read_options_t local_options = *options;
+                local_options.has_fractional_window = 1;
+                memcpy(local_options.fractional_window, c->fractional_window, sizeof(c->fractional_window));
+                c->mask.resize(static_cast<size_t>(c->dst_window[0]) * c->dst_window[1]);
+                local_options.mask = c->mask.data();
+                local_options.mask_packed = 0;
+                void *destination;
+                if (i == 0)
+                {
+                    // Straight into the destination buffer
+                    local_options.pixel_space = size;
+                    local_options.line_space = size * width;
+                    local_options.band_space = band_stride;
+                    destination = bytes + size * (static_cast<size_t>(c->dst_offset[1]) * width + c->dst_offset[0]);
+                }
+                else
+                {
+                    c->pixels.resize(size * c->dst_window[0] * c->dst_window[1] * band_count);
+                    destination = c->pixels.data();
+                }
+                if (deadline_passed(deadline))
+                {
+                    c->code = -CPLE_FileIO;
+                    return;
+                }
+                c->code = get_data_ex(c->token, locked_dataset::WARPED, attempts, nanos_until(deadline), copies,
+                                      c->src_window, c->dst_window, type, destination, &local_options);
+            });
+        }
+        group.wait();
+    }
+
+    // First valid pixel wins
+    int touched = 0;
+    auto filled = std::vector<uint8_t>(static_cast<size_t>(width) * height, 0);
+    for (size_t i = 0; i < contributions.size(); ++i)
+    {
+        const auto &c = contributions[i];
+        if (c.code < 0)
+        {
+            return c.code;
+        }
+        touched += c.code;
+
+        const size_t src_band_stride = size * c.dst_window[0] * c.dst_window[1];
+        for (int y = 0; y < c.dst_window[1]; ++y)
+        {
+            for (int x = 0; x < c.dst_window[0]; ++x)
+            {
+                const size_t src_index = static_cast<size_t>(y) * c.dst_window[0] + x;
+                const size_t dst_index = static_cast<size_t>(y + c.dst_offset[1]) * width + (x + c.dst_offset[0]);
+                if (filled[dst_index])
+                {
+                    continue;
+                }
+                if (c.mask[src_index] == 0)
+                {
+                    continue;
+                }
+                const uint8_t *pixel = (i == 0) ? bytes + size * dst_index : c.pixels.data() + size * src_index;
+                if (i != 0)
+                {
+                    for (int b = 0; b < band_count; ++b)
+                    {
+                        memcpy(bytes + b * band_stride + size * dst_index, pixel + b * src_band_stride, size);
+                    }
+                }
+                filled[dst_index] = 1;
+            }
+        }
+    }
+
+    return touched;
+}
+
+/**
+ * Warp the source dataset of a token onto an arbitrary target grid.
+ * Unlike a token with its own warp options, this builds no warped
+ * VRT and occupies no slot in the dataset cache, so it suits many
+ * one-off grids (for example web tiles in several projections).
+ * Each band is masked by its own NODATA value, if it has one; pixels
+ * that no valid source pixel covers are set to that value (zero for
+ * bands without one).
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param dst_srs The target CRS (anything that OSRSetFromUserInput
+ *                understands, for example "EPSG:3857" or WKT)
+ * @param dst_transform The geotransform of the target grid
+ * @param dst_size The width and height of the target grid
+ * @param resample The resampling algorithm (a GDALResampleAlg)
+ * @param _type The desired type of returned pixels (the argument is
+ *              of integral type GDALDataType)
+ * @param data The return-location of the warped data
+ * @param options The bands to read and the layout of the returned
+ *                data (NULL for all bands, band-sequential); overviews,
+ *                fractional windows, masks and RasterIO resampling do
+ *                not apply
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int warp_into(uint64_t token, int attempts, uint64_t nanos, int copies,
+              const char *dst_srs,
+              const double dst_transform[6],
+              const int dst_size[2],
+              int resample,
+              int _type,
+              void *data,
+              const read_options_t *options)
+{
+    auto type = static_cast<GDALDataType>(_type);
+    read_options_t default_options;
+    if (options == nullptr)
+    {
+        INIT_READ_OPTIONS(default_options);
+        options = &default_options;
+    }
+    if (dst_srs == nullptr || dst_size[0] <= 0 || dst_size[1] <= 0 ||
+        (options->band_list != nullptr && options->band_count <= 0) ||
+        options->overview >= 0 || options->has_fractional_window || options->resampling != 0 ||
+        options->mask != nullptr)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    std::string dst_wkt;
+    {
+        auto srs = OSRNewSpatialReference(nullptr);
+        char *wkt = nullptr;
+        if (OSRSetFromUserInput(srs, dst_srs) == OGRERR_NONE && OSRExportToWkt(srs, &wkt) == OGRERR_NONE)
+        {
+            dst_wkt = std::string(wkt);
+        }
+        CPLFree(wkt);
+        OSRDestroySpatialReference(srs);
+    }
+    if (dst_wkt.empty())
+    {
+        return -CPLE_IllegalArg;
+    }
+
+#if !defined(__linux__)
+    nanos = 0;
+#endif
+    DOIT(warp_into(dst_wkt.c_str(), dst_transform, dst_size, static_cast<GDALResampleAlg>(resample), type, data, options, transformers))
+}
+
+/**
+ * Encode band-sequential pixels with a GDAL driver (through
+ * GDALCreateCopy from a MEM dataset over the pixels into a /vsimem/
+ * file) and take ownership of the encoded bytes.
+ *
+ * @return Zero on success (the caller must CPLFree *out), negative
+ *         CPLErrorNum on failure
+ */
+static int encode_tile(const char *format, const char **creation_options,
+                       const int dst_window[2], int band_count, GDALDataType type,
+                       uint8_t *pixels,
+                       void **out, int64_t *size)
+{
+    static std::atomic<uint64_t> serial(0);
+
+    auto driver = GDALGetDriverByName(format);
+    if (driver == nullptr)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    auto mem = GDALCreate(GDALGetDriverByName("MEM"), "", dst_window[0], dst_window[1], 0, type, nullptr);
+    if (mem == nullptr)
+    {
+        return -CPLE_AppDefined;
+    }
+    const size_t band_size = static_cast<size_t>(dst_window[0]) * dst_window[1] * GDALGetDataTypeSizeBytes(type);
+    for (int i = 0; i < band_count; ++i)
+    {
+        char pointer[64];
+        snprintf(pointer, sizeof(pointer), "DATAPOINTER=%p", static_cast<void *>(pixels + i * band_size));
+        const char *band_options[] = {pointer, nullptr};
+        GDALAddBand(mem, type, const_cast<char **>(band_options));
+    }
+
+    auto filename = std::string("/vsimem/gdalwarp_tile_") + std::to_string(serial++);
+    auto encoded = GDALCreateCopy(driver, filename.c_str(), mem, FALSE,
+                                  const_cast<char **>(creation_options), nullptr, nullptr);
+    int retval = 0;
+    if (encoded == nullptr)
+    {
+        retval = get_last_errno();
+        retval = (retval == CPLE_None) ? -CPLE_AppDefined : -retval;
+    }
+    else
+    {
+        GDALClose(encoded);
+    }
+    GDALClose(mem);
+
+    // Take ownership of the file contents (this also unlinks the file)
+    vsi_l_offset length = 0;
+    GByte *bytes = VSIGetMemFileBuffer(filename.c_str(), &length, TRUE);
+    VSIUnlink((filename + ".aux.xml").c_str());
+    if (retval == 0 && bytes == nullptr)
+    {
+        retval = -CPLE_AppDefined;
+    }
+    if (retval < 0)
+    {
+        CPLFree(bytes);
+        return retval;
+    }
+    *out = bytes;
+    *size = static_cast<int64_t>(length);
+    return 0;
+}
+
+/**
+ * Read a tile and encode it (as PNG, JPEG, WEBP, or in any other
+ * format whose GDAL driver supports CreateCopy), handing back the
+ * encoded bytes in a buffer allocated by this library.  The pixels
+ * are read as by get_data_ex, wrapped in a MEM dataset, and encoded
+ * by the driver into a /vsimem/ file whose contents become the
+ * returned buffer; the dataset lock is released before encoding
+ * starts.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for the read (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param src_window The source window (see get_data)
+ * @param dst_window The width and height of the tile
+ * @param _type The type of the encoded pixels (the argument is of
+ *              integral type GDALDataType; most encoders want GDT_Byte)
+ * @param format The short name of the GDAL driver, e.g. "PNG"
+ * @param creation_options NULL-terminated driver creation options,
+ *                         e.g. "QUALITY=85" (NULL for none)
+ * @param options The bands to read, the overview, resampling and
+ *                fractional window (see get_data_ex); the layout
+ *                must be the default, and masks are not supported
+ *                (NULL for all bands)
+ * @param out The return-location of the encoded tile (to be freed
+ *            with free_encoded_tile)
+ * @param size The return-location of the size of the encoded tile
+ *             in bytes
+ * @return The number of attempts on success, negative CPLErrorNum on
+ *         failure
+ */
+int get_encoded_tile_buffer(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                            int src_window[4],
+                            int dst_window[2],
+                            int _type,
+                            const char *format,
+                            const char **creation_options,
+                            const read_options_t *options,
+                            void **out, int64_t *size)
+{
+    auto type = static_cast<GDALDataType>(_type);
+    read_options_t tile_options;
+    if (options != nullptr)
+    {
+        tile_options = *options;
+    }
+    else
+    {
+        INIT_READ_OPTIONS(tile_options);
+    }
+    if (format == nullptr || out == nullptr || size == nullptr || dst_window[0] <= 0 || dst_window[1] <= 0 ||
+        tile_options.band_count < 0 || tile_options.interleave != INTERLEAVE_BAND ||
+        tile_options.pixel_space != 0 || tile_options.line_space != 0 || tile_options.band_space != 0 ||
+        tile_options.mask != nullptr)
+    {
+        return -CPLE_IllegalArg;
+    }
+    if (tile_options.band_count == 0)
+    {
+        // All bands, so no band list applies
+        tile_options.band_list = nullptr;
+        int retval = get_band_count(token, dataset, attempts, nanos, copies, &tile_options.band_count);
+        if (retval < 0)
+        {
+            return retval;
+        }
+    }
+
+    auto pixels = std::vector<uint8_t>(static_cast<size_t>(dst_window[0]) * dst_window[1] *
+                                       tile_options.band_count * GDALGetDataTypeSizeBytes(type));
+    int retval = get_data_ex(token, dataset, attempts, nanos, copies, src_window, dst_window, _type, pixels.data(), &tile_options);
+    if (retval < 0)
+    {
+        return retval;
+    }
+
+    int code = encode_tile(format, creation_options, dst_window, tile_options.band_count, type, pixels.data(),
+                           out, size);
+    return (code < 0) ? code : retval;
+}
+
+/**
+ * Free a buffer returned by get_encoded_tile_buffer.
+ *
+ * @param buffer The buffer (NULL is allowed)
+ */
+void free_encoded_tile(void *buffer)
+{
+    CPLFree(buffer);
+}
+
+/**
+ * Read a tile and encode it, as get_encoded_tile_buffer does, into a
+ * buffer owned by the caller.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for the read (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param src_window The source window (see get_data)
+ * @param dst_window The width and height of the tile
+ * @param _type The type of the encoded pixels (see get_encoded_tile_buffer)
+ * @param format The short name of the GDAL driver, e.g. "PNG"
+ * @param creation_options NULL-terminated driver creation options
+ *                         (NULL for none)
+ * @param options See get_encoded_tile_buffer
+ * @param out The return-location of the encoded tile
+ * @param max_size The size of the return buffer in bytes
+ * @param size The return-location of the size of the encoded tile
+ *             in bytes (set even if the return buffer is too small)
+ * @return The number of attempts on success, negative CPLErrorNum on
+ *         failure (-CPLE_AppDefined if the return buffer is too
+ *         small)
+ */
+int get_encoded_tile(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                     int src_window[4],
+                     int dst_window[2],
+                     int _type,
+                     const char *format,
+                     const char **creation_options,
+                     const read_options_t *options,
+                     void *out, int64_t max_size, int64_t *size)
+{
+    void *buffer = nullptr;
+    int retval = get_encoded_tile_buffer(token, dataset, attempts, nanos, copies, src_window, dst_window, _type,
+                                         format, creation_options, options, &buffer, size);
+    if (retval < 0)
+    {
+        return retval;
+    }
+    if (*size > max_size)
+    {
+        retval = -CPLE_AppDefined;
+    }
+    else
+    {
+        memcpy(out, buffer, *size);
+    }
+    free_encoded_tile(buffer);
+    return retval;
+}
+
+/**
+ * The Arrow format string of a GDAL data type (see
+ * https://arrow.apache.org/docs/format/CDataInterface.html#data-type-description-format-strings).
+ *
+ * @param type The GDAL data type
+ * @return The format string, or nullptr if the type has no Arrow
+ *         primitive counterpart
+ */
+static const char *arrow_format(GDALDataType type)
+{
+    switch (type)
+    {
+    case GDT_Byte:
+        return "C";
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 7, 0)
+    case GDT_Int8:
+        return "c";
+#endif
+    case GDT_UInt16:
+        return "S";
+    case GDT_Int16:
+        return "s";
+    case GDT_UInt32:
+        return "I";
+    case GDT_Int32:
+        return "i";
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 5, 0)
+    case GDT_UInt64:
+        return "L";
+    case GDT_Int64:
+        return "l";
+#endif
+    case GDT_Float32:
+        return "f";
+    case GDT_Float64:
+        return "g";
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * The producer-private part of an exported Arrow array: the memory
+ * of the columns and the child structures that describe them.
+ */
+struct arrow_array_export_t
+{
+    void *data;                       // All columns, each 64-byte aligned
+    std::vector<void *> validity;     // One bitmap per column (or nullptr)
+    std::vector<const void *> buffers; // Two per column (validity, data)
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray *> child_pointers;
+    const void *struct_buffers[1];    // The (absent) validity of the struct
+};
+
+/**
+ * The producer-private part of an exported Arrow schema.
+ */
+struct arrow_schema_export_t
+{
+    std::vector<std::string> names;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema *> child_pointers;
+};
+
+static void release_arrow_child_array(ArrowArray *array)
+{
+    array->release = nullptr;
+}
+
+static void release_arrow_array(ArrowArray *array)
+{
+    auto exported = static_cast<arrow_array_export_t *>(array->private_data);
+    for (auto &child : exported->children)
+    {
+        if (child.release != nullptr)
+        {
+            child.release(&child);
+        }
+    }
+    for (auto validity : exported->validity)
+    {
+        VSIFreeAligned(validity);
+    }
+    VSIFreeAligned(exported->data);
+    delete exported;
+    array->release = nullptr;
+}
+
+static void release_arrow_child_schema(ArrowSchema *schema)
+{
+    schema->release = nullptr;
+}
+
+static void release_arrow_schema(ArrowSchema *schema)
+{
+    auto exported = static_cast<arrow_schema_export_t *>(schema->private_data);
+    for (auto &child : exported->children)
+    {
+        if (child.release != nullptr)
+        {
+            child.release(&child);
+        }
+    }
+    delete exported;
+    schema->release = nullptr;
+}
+
+/**
+ * Round a size up to a multiple of 64 bytes (the alignment and
+ * padding that Arrow recommends for buffers).
+ */
+static int64_t arrow_padded(int64_t size)
+{
+    return (size + 63) & ~static_cast<int64_t>(63);
+}
+
+/**
+ * Get pixel data as an Arrow struct array (through the Arrow C Data
+ * Interface) with one column per band and one row per pixel, in
+ * row-major order.  The buffers are allocated natively and are freed
+ * when the consumer calls the release callbacks, so Arrow
+ * implementations can import the result without copying.
+ *
+ * If validity is requested, each band is read together with its mask
+ * (which reflects its NODATA value, if any), packed into an Arrow
+ * validity bitmap; the bands are then read one at a time.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param src_window The source window (see get_data)
+ * @param dst_window The destination size (see get_data)
+ * @param _type The desired type of returned pixels (the argument is
+ *              of integral type GDALDataType; complex types are not
+ *              supported)
+ * @param options The bands to read, the overview, resampling and
+ *                fractional window (see get_data_ex); the layout is
+ *                fixed and masks are given through validity (NULL for
+ *                all bands at full resolution)
+ * @param validity Whether to export validity bitmaps
+ * @param array The return-location of the array
+ * @param schema The return-location of its schema
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int get_data_arrow(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                   int src_window[4],
+                   int dst_window[2],
+                   int _type,
+                   const read_options_t *options,
+                   int validity,
+                   struct ArrowArray *array,
+                   struct ArrowSchema *schema)
+{
+    auto type = static_cast<GDALDataType>(_type);
+    const char *format = arrow_format(type);
+    read_options_t base_options;
+
+    if (options != nullptr)
+    {
+        base_options = *options;
+    }
+    else
+    {
+        INIT_READ_OPTIONS(base_options);
+    }
+    if (format == nullptr)
+    {
+        return -CPLE_NotSupported;
+    }
+    if (array == nullptr || schema == nullptr || dst_window[0] <= 0 || dst_window[1] <= 0 ||
+        base_options.band_count < 0 || base_options.interleave != INTERLEAVE_BAND ||
+        base_options.pixel_space != 0 || base_options.line_space != 0 || base_options.band_space != 0 ||
+        base_options.mask != nullptr)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    // The bands to read
+    auto band_list = std::vector<int>();
+    if (base_options.band_count == 0)
+    {
+        int band_count, code;
+        if ((code = get_band_count(token, dataset, attempts, nanos, copies, &band_count)) < 0)
+        {
+            return code;
+        }
+        for (int i = 1; i <= band_count; ++i)
+        {
+            band_list.push_back(i);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < base_options.band_count; ++i)
+        {
+            band_list.push_back(base_options.band_list != nullptr ? base_options.band_list[i] : i + 1);
+        }
+    }
+    const int band_count = static_cast<int>(band_list.size());
+    const int64_t length = static_cast<int64_t>(dst_window[0]) * dst_window[1];
+    const int64_t column_bytes = arrow_padded(length * GDALGetDataTypeSizeBytes(type));
+    const int64_t bitmap_bytes = arrow_padded(MASK_BYTES(dst_window[0], dst_window[1], 1));
+
+    auto exported = new arrow_array_export_t();
+    exported->data = VSIMallocAligned(64, std::max<int64_t>(column_bytes * band_count, 64));
+    exported->validity.assign(band_count, nullptr);
+    if (exported->data == nullptr)
+    {
+        delete exported;
+        return -CPLE_OutOfMemory;
+    }
+    auto columns = static_cast<uint8_t *>(exported->data);
+
+    // Read the pixels (and masks)
+    int retval = 0;
+    if (!validity)
+    {
+        read_options_t read_options = base_options;
+        read_options.band_count = band_count;
+        read_options.band_list = band_list.data();
+        read_options.band_space = column_bytes;
+        retval = get_data_ex(token, dataset, attempts, nanos, copies, src_window, dst_window, _type, columns, &read_options);
+    }
+    else
+    {
+        for (int i = 0; i < band_count && retval >= 0; ++i)
+        {
+            auto bitmap = static_cast<uint8_t *>(VSIMallocAligned(64, bitmap_bytes));
+            if (bitmap == nullptr)
+            {
+                retval = -CPLE_OutOfMemory;
+                break;
+            }
+            memset(bitmap, 0, bitmap_bytes);
+            exported->validity[i] = bitmap;
+
+            read_options_t read_options = base_options;
+            read_options.band_count = 1;
+            read_options.band_list = &band_list[i];
+            read_options.mask = bitmap;
+            read_options.mask_packed = 1;
+            int code = get_data_ex(token, dataset, attempts, nanos, copies, src_window, dst_window, _type,
+                                   columns + i * column_bytes, &read_options);
+            retval = (code < 0) ? code : retval + code;
+        }
+    }
+    if (retval < 0)
+    {
+        for (auto bitmap : exported->validity)
+        {
+            VSIFreeAligned(bitmap);
+        }
+        VSIFreeAligned(exported->data);
+        delete exported;
+        return retval;
+    }
+
+    // Describe the columns
+    exported->buffers.resize(2 * band_count);
+    exported->children.resize(band_count);
+    exported->child_pointers.resize(band_count);
+    for (int i = 0; i < band_count; ++i)
+    {
+        int64_t null_count = 0;
+        if (exported->validity[i] != nullptr)
+        {
+            auto bitmap = static_cast<const uint8_t *>(exported->validity[i]);
+            int64_t valid = 0;
+            for (int64_t j = 0; j < length / 8; ++j)
+            {
+                valid += __builtin_popcount(bitmap[j]);
+            }
+            for (int64_t j = length - length % 8; j < length; ++j)
+            {
+                valid += (bitmap[j / 8] >> (j % 8)) & 1;
+            }
+            null_count = length - valid;
+        }
+        // An absent bitmap means that every value is valid
+        if (null_count == 0 && exported->validity[i] != nullptr)
+        {
+            VSIFreeAligned(exported->validity[i]);
+            exported->validity[i] = nullptr;
+        }
+        exported->buffers[2 * i] = exported->validity[i];
+        exported->buffers[2 * i + 1] = columns + i * column_bytes;
+
+        ArrowArray &child = exported->children[i];
+        child.length = length;
+        child.null_count = null_count;
+        child.offset = 0;
+        child.n_buffers = 2;
+        child.n_children = 0;
+        child.buffers = &exported->buffers[2 * i];
+        child.children = nullptr;
+        child.dictionary = nullptr;
+        child.release = release_arrow_child_array;
+        child.private_data = nullptr;
+        exported->child_pointers[i] = &child;
+    }
+    exported->struct_buffers[0] = nullptr;
+
+    array->length = length;
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = 1;
+    array->n_children = band_count;
+    array->buffers = exported->struct_buffers;
+    array->children = exported->child_pointers.data();
+    array->dictionary = nullptr;
+    array->release = release_arrow_array;
+    array->private_data = exported;
+
+    // Describe the schema
+    auto described = new arrow_schema_export_t();
+    described->names.resize(band_count);
+    described->children.resize(band_count);
+    described->child_pointers.resize(band_count);
+    for (int i = 0; i < band_count; ++i)
+    {
+        described->names[i] = "band_" + std::to_string(band_list[i]);
+
+        ArrowSchema &child = described->children[i];
+        child.format = format;
+        child.name = described->names[i].c_str();
+        child.metadata = nullptr;
+        child.flags = validity ? ARROW_FLAG_NULLABLE : 0;
+        child.n_children = 0;
+        child.children = nullptr;
+        child.dictionary = nullptr;
+        child.release = release_arrow_child_schema;
+        child.private_data = nullptr;
+        described->child_pointers[i] = &child;
+    }
+
+    schema->format = "+s";
+    schema->name = "";
+    schema->metadata = nullptr;
+    schema->flags = 0;
+    schema->n_children = band_count;
+    schema->children = described->child_pointers.data();
+    schema->dictionary = nullptr;
+    schema->release = release_arrow_schema;
+    schema->private_data = described;
+
+    return retval;
+}
+
+/**
+ * Prefetch the given window on the first copy of a dataset that is
+ * not in use, making at most the given number of passes over the
+ * copies.
+ */
+static int prefetch_now(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                        const int src_window[4],
+                        const std::vector<int> &band_list,
+                        bool warm)
+{
+    DOIT(prefetch(dataset, src_window, static_cast<int>(band_list.size()),
+                  band_list.empty() ? nullptr : band_list.data(), warm))
+}
+
+/**
+ * Announce that a window is about to be read.  This returns
+ * immediately; in the background, the first copy of the dataset that
+ * is not in use is told about the upcoming read (see
+ * GDALDatasetAdviseRead) and, if requested, reads the window once to
+ * warm the block cache and (for remote files) the /vsicurl/ region
+ * cache.  If every copy is still busy after the given number of
+ * attempts, the prefetch is dropped.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of passes over the copies to make
+ *                 before the prefetch is dropped
+ * @param nanos The approximate time budget of the prefetch (in
+ *              nanoseconds), counted from when it starts in the
+ *              background
+ * @param copies The desired number of datasets
+ * @param src_window The window that will be read (see get_data)
+ * @param band_count The number of bands that will be read (zero for
+ *                   all bands)
+ * @param band_list The bands that will be read (NULL for 1
+ *                  ... band_count)
+ * @param warm Whether to read the window in the background
+ * @return 1 if the prefetch was queued, negative CPLErrorNum on
+ *         failure (-CPLE_AppDefined if the library is not initialized)
+ */
+int prefetch(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+             const int src_window[4],
+             int band_count,
+             const int *band_list,
+             int warm)
+{
+    if ((dataset != locked_dataset::SOURCE && dataset != locked_dataset::WARPED) ||
+        src_window[2] <= 0 || src_window[3] <= 0 || band_count < 0)
+    {
+        return -CPLE_IllegalArg;
+    }
+    if (pool == nullptr)
+    {
+        return -CPLE_AppDefined;
+    }
+    if (!query_token(token))
+    {
+        return -CPLE_OpenFailed;
+    }
+
+    auto window = std::vector<int>(src_window, src_window + 4);
+    auto bands = std::vector<int>();
+    for (int i = 0; i < band_count; ++i)
+    {
+        bands.push_back(band_list != nullptr ? band_list[i] : i + 1);
+    }
+    pool->submit([=]() {
+        prefetch_now(token, dataset, attempts, nanos, copies, window.data(), bands, warm != 0);
+    });
+
+    return 1;
+}
+
+/**
+ * An asynchronous read (see submit_get_data).
+ */
+struct async_request_t
+{
+    int64_t id;
+    uint64_t token;
+    int dataset;
+    int attempts;
+    int copies;
+    uint64_t deadline;    // No attempt is started after this
+    uint64_t io_deadline; // Enforced inside GDAL (explicit budgets only)
+    int src_window[4];
+    int dst_window[2];
+    GDALDataType type;
+    void *data;
+    read_options_t options;
+    std::vector<int> band_list;
+    completion_callback_t callback;
+    void *tag;
+    int made;    /* Passes made so far */
+    int touched; /* Datasets touched so far */
+};
+
+/**
+ * Make one pass over the copies of a dataset, performing the read on
+ * the first one that is not in use.
+ *
+ * @param request The read to perform (its count of datasets touched
+ *                is updated)
+ * @param fatal The return-location of whether the failure (if any)
+ *              is one that DOIT does not retry
+ * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+ */
+static int get_data_now(async_request_t *request, bool *fatal)
+{
+    *fatal = true;
+    auto query_result = query_token(request->token);
+    if (!query_result)
+    {
+        return -CPLE_OpenFailed;
+    }
+
+    deadline_scope deadline(request->io_deadline);
+    auto locked_datasets = cache->get(query_result.get(), request->copies);
+    if (locked_datasets.size() == 0)
+    {
+        return -CPLE_OpenFailed;
+    }
+
+    *fatal = false;
+    bool done = false;
+    int code = CPLE_None;
+    int touched = 0;
+    TRY(get_pixels_ex(request->dataset, request->src_window, request->dst_window,
+                      request->type, request->data, &request->options))
+    request->touched += touched;
+    return code;
+}
+
+/**
+ * Run an asynchronous read on the worker pool.  Each run makes one
+ * pass over the copies of the dataset.  Failed passes are retried as
+ * DOIT retries them (until the attempts or the time budget run out),
+ * after a short backoff that doubles with each pass (up to a
+ * millisecond); the request then goes to the back of the queue, so
+ * that it does not hold a worker thread while other requests wait
+ * (without worker threads, the passes are made in a loop instead).
+ * The result is then handed to the callback of the request, or else
+ * to the completion queue.  Once deinit has begun, requests finish
+ * with -CPLE_UserInterrupt instead of making further passes.
+ *
+ * @param request The read to perform
+ */
+static void run_request(std::shared_ptr<async_request_t> request)
+{
+    int retval;
+
+    while (true)
+    {
+        if (requests_stopping)
+        {
+            retval = -CPLE_UserInterrupt;
+            break;
+        }
+        if (request->deadline > 0 && get_nanos() > request->deadline)
+        {
+            retval = -CPLE_FileIO;
+            break;
+        }
+
+        bool fatal;
+        retval = get_data_now(request.get(), &fatal);
+        ++request->made;
+        if (retval == ATTEMPT_SUCCESSFUL)
+        {
+            retval = request->touched;
+            break;
+        }
+        else if (fatal)
+        {
+            break;
+        }
+        else if (request->attempts > 0 && request->made >= request->attempts)
+        {
+            retval = (retval == DATASET_LOCKED) ? -ATTEMPTS_EXCEEDED : retval;
+            break;
+        }
+
+        uint64_t micros = std::min(1000, 16 << std::min(request->made, 6));
+        if (request->deadline > 0)
+        {
+            const uint64_t now = get_nanos();
+            micros = std::min(micros, (request->deadline > now) ? (request->deadline - now) / 1000 : 0);
+        }
+        if (!requests_stopping && micros > 0)
+        {
+            usleep(static_cast<useconds_t>(micros));
+        }
+        if (pool->size() > 0)
+        {
+            pool->submit([request]() { run_request(request); });
+            return;
+        }
+    }
+
+    if (request->callback != nullptr)
+    {
+        request->callback(request->id, retval, request->tag);
+    }
+    else
+    {
+        completions->push(request->id, retval, request->tag);
+    }
+}
+
+/**
+ * Begin reading pixel data in the background.  The arguments are
+ * those of get_data_ex; the read runs on the worker pool (or, if
+ * there are no worker threads, before this function returns) and its
+ * result, which is what get_data_ex would have returned (or
+ * -CPLE_UserInterrupt if deinit cuts it short), is delivered
+ * either to the given callback (on a worker thread) or, if there is
+ * no callback, to the completion queue (see poll_completions).  The
+ * data buffer (and the mask, if any) must remain valid until then.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call, counted
+ *              from submission (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param src_window The source window (see get_data_ex)
+ * @param dst_window The destination size (see get_data_ex)
+ * @param _type The desired type of returned pixels (the argument is
+ *              of integral type GDALDataType)
+ * @param data The return-location of the read data
+ * @param options See get_data_ex (copied; NULL for the defaults)
+ * @param callback The function to call on completion (NULL to use
+ *                 the completion queue)
+ * @param tag An opaque value passed back on completion
+ * @return The (positive) id of the request, negative CPLErrorNum on
+ *         failure (-CPLE_AppDefined if the library is not initialized)
+ */
+int64_t submit_get_data(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                        const int src_window[4],
+                        const int dst_window[2],
+                        int _type,
+                        void *data,
+                        const read_options_t *options,
+                        completion_callback_t callback,
+                        void *tag)
+{
+    if ((dataset != locked_dataset::SOURCE && dataset != locked_dataset::WARPED) ||
+        data == nullptr || (options != nullptr && options->band_count < 0))
+    {
+        return -CPLE_IllegalArg;
+    }
+    if (pool == nullptr || completions == nullptr || requests_stopping)
+    {
+        return -CPLE_AppDefined;
+    }
+    if (!query_token(token))
+    {
+        return -CPLE_OpenFailed;
+    }
+#if !defined(__linux__)
+    nanos = 0;
+#endif
+
+    auto request = std::make_shared<async_request_t>();
+    request->id = next_request_id++;
+    request->token = token;
+    request->dataset = dataset;
+    request->attempts = attempts;
+    request->copies = copies;
+    const uint64_t budget = (nanos > 0) ? nanos : default_nanos;
+    const uint64_t now = get_nanos();
+    request->deadline = (budget > 0 && now > 0) ? now + budget : 0;
+    request->io_deadline = (nanos > 0 && now > 0) ? now + nanos : 0;
+    std::copy(src_window, src_window + 4, request->src_window);
+    std::copy(dst_window, dst_window + 2, request->dst_window);
+    request->type = static_cast<GDALDataType>(_type);
+    request->data = data;
+    if (options != nullptr)
+    {
+        request->options = *options;
+        if (options->band_list != nullptr)
+        {
+            request->band_list.assign(options->band_list, options->band_list + options->band_count);
+            request->options.band_list = request->band_list.data();
+        }
+    }
+    else
+    {
+        INIT_READ_OPTIONS(request->options);
+    }
+    request->callback = callback;
+    request->tag = tag;
+    request->made = 0;
+    request->touched = 0;
+
+    const int64_t id = request->id;
+    pool->submit([request]() { run_request(request); });
+
+    return id;
+}
+
+/**
+ * Take the results of finished asynchronous reads that were
+ * submitted without a callback (see submit_get_data), oldest first.
+ *
+ * @param ids The return-location of the ids of the requests
+ * @param results The return-location of their results
+ * @param tags The return-location of their tags (may be NULL)
+ * @param max_count The size of the return-locations
+ * @param wait_nanos How long to wait for a result if there is none
+ *                   yet (in nanoseconds; zero to return immediately)
+ * @return The number of results taken, or -CPLE_ObjectNull once the
+ *         library has been deinitialized and every result has been
+ *         taken (pollers should then stop)
+ */
+int poll_completions(int64_t *ids, int *results, void **tags, int max_count, uint64_t wait_nanos)
+{
+    if (completions == nullptr)
+    {
+        return -CPLE_ObjectNull;
+    }
+    auto taken = std::vector<completion_queue::completion_t>(std::max(max_count, 0));
+    int count = completions->poll(taken.data(), max_count, wait_nanos);
+    if (count < 0)
+    {
+        return -CPLE_ObjectNull;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        ids[i] = taken[i].id;
+        results[i] = taken[i].result;
+        if (tags != nullptr)
+        {
+            tags[i] = taken[i].tag;
+        }
+    }
+    return count;
+}
+
+/**
+ * Check out a page-aligned buffer from the pool of reusable read
+ * buffers (see GDALWARP_BUFFER_POOL_BYTES and
+ * GDALWARP_BUFFER_POOL_HUGEPAGES).  Steady-state reads into pooled
+ * buffers allocate no memory.
+ *
+ * @param size The minimum size of the buffer in bytes
+ * @param capacity The return-location of the actual size of the
+ *                 buffer (a power of two; may be NULL)
+ * @return The buffer, or NULL on failure
+ */
+void *acquire_buffer(int64_t size, int64_t *capacity)
+{
+    size_t actual = 0;
+    void *buffer = nullptr;
+
+    if (size < 0 || buffers == nullptr)
+    {
+        return nullptr;
+    }
+    buffer = buffers->acquire(static_cast<size_t>(size), &actual);
+    if (capacity != nullptr)
+    {
+        *capacity = static_cast<int64_t>(actual);
+    }
+    return buffer;
+}
+
+/**
+ * Return a buffer to the pool of reusable read buffers.  The buffer
+ * must not be used afterward.  (Buffers that were checked out before
+ * the last deinit are not known to the current pool and are rejected.)
+ *
+ * @param buffer A buffer returned by acquire_buffer
+ * @return 1 on success, negative CPLErrorNum on failure
+ */
+int release_buffer(void *buffer)
+{
+    if (buffer == nullptr || buffers == nullptr || !buffers->release(buffer))
+    {
+        return -CPLE_IllegalArg;
+    }
+    return 1;
+}
+
+/**
+ * Get the the transform.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param transform The return location for the six double-precision
+ *                  floating point number that will be returned
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int get_transform(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                  double transform[6])
+{
+    DOIT(get_transform(dataset, transform))
+}
+
+/**
+ * Get all of the immutable properties of a dataset (dimensions,
+ * transform, CRS, and per-band types, NODATA values, offsets, scales,
+ * block sizes and overview sizes) in one call.  The layout of the
+ * record is described in dataset_info.h.  If the buffer is too small then
+ * the record is truncated; the size field of the header gives the
+ * required size.
+ *
+ * @param token A token associated with some uri ⨯ options pair
+ * @param dataset 0 (or locked_dataset::SOURCE) for the source
+ *                dataset, 1 (or locked_dataset::WARPED) for the
+ *                warped dataset
+ * @param attempts The number of attempts to make before giving up
+ * @param nanos The approximate time budget for this call (in nanoseconds)
+ * @param copies The desired number of datasets
+ * @param info The return location for the record
+ * @param max_size The size of the return buffer in bytes (must be at
+ *                 least sizeof(info_header_t))
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+int get_info(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+             void *info, int max_size)
+{
+    if (max_size < static_cast<int>(sizeof(info_header_t)))
+    {
+        return -CPLE_IllegalArg;
+    }
+    DOIT(get_info(dataset, info, max_size))
+}
+
+/**
+ * Describe the layout of read_options_t, so that bindings which
+ * mirror the struct in another language (see the FFM binding) can
+ * check their copy against the compiled one.  The entries are the
+ * size of the struct, then the offsets of band_count, band_list,
+ * interleave, pixel_space, line_space, band_space, overview,
+ * resampling, has_fractional_window, fractional_window, mask and
+ * mask_packed, in that order (all in bytes).
+ *
+ * @param layout The return-location of the entries
+ * @param max_count The size of the return-location
+ * @return The number of entries (13), or -CPLE_IllegalArg if they do
+ *         not fit
+ */
+int get_read_options_layout(int64_t *layout, int max_count)
+{
+    const int64_t entries[] = {
+        sizeof(read_options_t),
+        offsetof(read_options_t, band_count),
+        offsetof(read_options_t, band_list),
+        offsetof(read_options_t, interleave),
+        offsetof(read_options_t, pixel_space),
+        offsetof(read_options_t, line_space),
+        offsetof(read_options_t, band_space),
+        offsetof(read_options_t, overview),
+        offsetof(read_options_t, resampling),
+        offsetof(read_options_t, has_fractional_window),
+        offsetof(read_options_t, fractional_window),
+        offsetof(read_options_t, mask),
+        offsetof(read_options_t, mask_packed)};
+    const int count = static_cast<int>(sizeof(entries) / sizeof(entries[0]));
+
+    if (layout == nullptr || max_count < count)
+    {
+        return -CPLE_IllegalArg;
+    }
+    std::copy(entries, entries + count, layout);
+    return count;
 }
@@ -19,67 +19,81 @@
 
 #include <stdint.h>
 
+#include "arrow_c_data.h"
+#include "dataset_info.h"
+#include "read_options.h"
+#include "statistics.h"
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+    typedef void (*completion_callback_t)(int64_t id, int result, void *tag);
+
     void init(size_t size);
     void deinit();
 
     uint64_t get_token(const char *uri, const char **options);
 
-    int get_block_size(uint64_t token, int dataset, int attempts, int copies,
+    int get_block_size(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                        int band_number, int *width, int *height);
 
-    int get_histogram(uint64_t token, int dataset, int attempts, int copies,
+    int get_histogram(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                       int band_number,
                       double lower, double upper, int num_buckets,
                       unsigned long long int *hist,
                       int include_out_of_range, int approx_ok);
 
-    int get_offset(uint64_t token, int dataset, int attempts, int copies,
+    int get_offset(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                    int band_number, double *offset, int *success);
 
-    int get_scale(uint64_t token, int dataset, int attempts, int copies,
+    int get_scale(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                   int band_number, double *scale, int *success);
 
-    int noop(uint64_t token, int dataset, int attempts, int copies);
+    int noop(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies);
 
-    int get_color_interpretation(uint64_t token, int dataset, int attempts, int copies,
+    int get_color_interpretation(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                                  int band_number, int *color_interp);
 
-    int get_metadata_domain_list(uint64_t token, int dataset, int attempts, int copies,
+    int get_metadata_domain_list(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                                  int band_number, char ***domain_list);
 
-    int get_metadata(uint64_t token, int dataset, int attempts, int copies,
+    int get_metadata(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                      int band_number, const char *domain, char ***list);
 
-    int get_metadata_item(uint64_t token, int dataset, int attempts, int copies,
+    int get_metadata_item(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                           int band_number, const char *key, const char *domain, const char **value);
 
-    int get_overview_widths_heights(uint64_t token, int dataset, int attempts, int copies,
+    int get_overview_widths_heights(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                                     int band_number, int *widths, int *heights, int max_length);
 
-    int get_crs_wkt(uint64_t token, int dataset, int attempts, int copies,
+    int get_crs_wkt(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                     char *crs, int max_size);
 
-    int get_crs_proj4(uint64_t token, int dataset, int attempts, int copies,
+    int get_crs_proj4(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                       char *crs, int max_size);
 
-    int get_band_nodata(uint64_t token, int dataset, int attempts, int copies,
+    int get_band_nodata(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                         int band_number, double *nodata, int *success);
 
-    int get_band_min_max(uint64_t token, int dataset, int attempts, int copies,
+    int get_band_min_max(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                          int band_number, int approx_okay, double *minmax, int *success);
 
-    int get_band_data_type(uint64_t token, int dataset, int attempts, int copies,
+    int get_statistics(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                       int band_number, int approx_ok,
+                       int percentile_count,
+                       const double *percentiles,
+                       double *percentile_values,
+                       statistics_t *statistics);
+
+    int get_band_data_type(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                            int band_number, int *data_type);
 
-    int get_band_count(uint64_t token, int dataset, int attempts, int copies,
+    int get_band_count(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                        int *band_count);
 
-    int get_width_height(uint64_t token, int dataset, int attempts, int copies,
+    int get_width_height(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                          int *width, int *height);
 
     int get_data(uint64_t token, int datasets, int attempts, uint64_t nanos, int copies,
@@ -89,9 +103,95 @@ extern "C"
                  int type,
                  void *data);
 
-    int get_transform(uint64_t token, int dataset, int attempts, int copies,
+    int get_data_ex(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                    int src_window[4],
+                    int dst_window[2],
+                    int type,
+                    void *data,
+                    const read_options_t *options);
+
+    int get_data_batch(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                       int count,
+                       const int *src_windows,
+                       const int *dst_windows,
+                       int type,
+                       void *const *data,
+                       const read_options_t *options);
+
+    int get_mosaic(const uint64_t *tokens, int count, int attempts, uint64_t nanos, int copies,
+                   const double dst_extent[4],
+                   const int dst_size[2],
+                   int type,
+                   void *data,
+                   const read_options_t *options);
+
+    int prefetch(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                 const int src_window[4],
+                 int band_count,
+                 const int *band_list,
+                 int warm);
+
+    int warp_into(uint64_t token, int attempts, uint64_t nanos, int copies,
+                  const char *dst_srs,
+                  const double dst_transform[6],
+                  const int dst_size[2],
+                  int resample,
+                  int type,
+                  void *data,
+                  const read_options_t *options);
+
+    int get_encoded_tile(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                         int src_window[4],
+                         int dst_window[2],
+                         int type,
+                         const char *format,
+                         const char **creation_options,
+                         const read_options_t *options,
+                         void *out, int64_t max_size, int64_t *size);
+
+    int get_encoded_tile_buffer(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                                int src_window[4],
+                                int dst_window[2],
+                                int type,
+                                const char *format,
+                                const char **creation_options,
+                                const read_options_t *options,
+                                void **out, int64_t *size);
+
+    void free_encoded_tile(void *buffer);
+
+    int get_data_arrow(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                       int src_window[4],
+                       int dst_window[2],
+                       int type,
+                       const read_options_t *options,
+                       int validity,
+                       struct ArrowArray *array,
+                       struct ArrowSchema *schema);
+
+    int64_t submit_get_data(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                            const int src_window[4],
+                            const int dst_window[2],
+                            int type,
+                            void *data,
+                            const read_options_t *options,
+                            completion_callback_t callback,
+                            void *tag);
+
+    int poll_completions(int64_t *ids, int *results, void **tags, int max_count, uint64_t wait_nanos);
+
+    void *acquire_buffer(int64_t size, int64_t *capacity);
+
+    int release_buffer(void *buffer);
+
+    int get_transform(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
                       double transform[6]);
 
+    int get_info(uint64_t token, int dataset, int attempts, uint64_t nanos, int copies,
+                 void *info, int max_size);
+
+    int get_read_options_layout(int64_t *layout, int max_count);
+
 #ifdef __cplusplus
 }
 #endif
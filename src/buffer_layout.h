@@ -0,0 +1,135 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BUFFER_LAYOUT_H__
+#define __BUFFER_LAYOUT_H__
+
+#include <stdint.h>
+
+#include <gdal.h>
+
+#include "read_options.h"
+
+/*
+ * Checks of the layout of a caller's buffer (a Java array or direct
+ * buffer) against a read, made before GDAL is allowed to write into
+ * it.
+ */
+
+/*
+ * Fill in the spacings (pixel, line, band) that were given as zero
+ * with those implied by the interleaving.
+ *
+ * @param interleave One of the INTERLEAVE_* values
+ * @param type The GDALDataType of the elements of the buffer
+ * @param width The number of pixels per line
+ * @param height The number of lines per band
+ * @param band_count The number of bands
+ * @param spacing The pixel, line and band spacing in bytes
+ * @return 1 on success, 0 if the interleaving is not recognized
+ */
+static inline int resolve_spacing(int interleave, int type, int width, int height, int band_count,
+                                  int64_t spacing[3])
+{
+    int64_t size = GDALGetDataTypeSizeBytes((GDALDataType)type);
+    int64_t defaults[3];
+
+    switch (interleave)
+    {
+    case INTERLEAVE_BAND:
+        defaults[0] = size;
+        defaults[1] = size * width;
+        defaults[2] = size * width * height;
+        break;
+    case INTERLEAVE_PIXEL:
+        defaults[0] = size * band_count;
+        defaults[1] = size * band_count * width;
+        defaults[2] = size;
+        break;
+    case INTERLEAVE_LINE:
+        defaults[0] = size;
+        defaults[1] = size * width * band_count;
+        defaults[2] = size * width;
+        break;
+    default:
+        return 0;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        if (spacing[i] == 0)
+        {
+            spacing[i] = defaults[i];
+        }
+    }
+    return 1;
+}
+
+/*
+ * Answer whether every element written by a read with the given
+ * layout falls within an array of the given length.
+ *
+ * @param offset The offset (in bytes) of the first element
+ * @param type The GDALDataType of the elements of the buffer
+ * @param width The number of pixels per line
+ * @param height The number of lines per band
+ * @param band_count The number of bands
+ * @param spacing The pixel, line and band spacing in bytes
+ * @param length The length of the array in bytes
+ * @return 1 if the read fits, 0 otherwise
+ */
+static inline int fits(int64_t offset, int type, int width, int height, int band_count,
+                       const int64_t spacing[3], int64_t length)
+{
+    int64_t counts[3] = {width, height, band_count};
+    int64_t lo = offset;
+    int64_t hi = offset + GDALGetDataTypeSizeBytes((GDALDataType)type);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (counts[i] <= 0)
+        {
+            return 0;
+        }
+        else if (spacing[i] < 0)
+        {
+            lo += (counts[i] - 1) * spacing[i];
+        }
+        else
+        {
+            hi += (counts[i] - 1) * spacing[i];
+        }
+    }
+    return (lo >= 0) && (hi <= length);
+}
+
+/*
+ * Answer whether the elements of a GDAL buffer type (or their
+ * components, for complex types) are the size of the elements of a
+ * typed Java array, so that GDAL may write straight into the array.
+ *
+ * @param type The GDALDataType of the elements of the buffer
+ * @param element_size The size in bytes of the array elements
+ * @return 1 if the sizes match, 0 otherwise (including for types of
+ *         unknown size)
+ */
+static inline int element_size_matches(int type, int element_size)
+{
+    int size = GDALGetDataTypeSizeBytes((GDALDataType)type);
+    int component_size = size / (GDALDataTypeIsComplex((GDALDataType)type) ? 2 : 1);
+    return (size > 0) && (component_size == element_size);
+}
+
+#endif
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BUFFER_POOL_HPP__
+#define __BUFFER_POOL_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include <pthread.h>
+
+#if defined(__MINGW32__)
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/*
+ * A pool of aligned, reusable read buffers.  Buffers come in
+ * power-of-two size classes; a buffer that is checked back in is
+ * kept for the next request of its class, up to a total of capacity
+ * idle bytes, so that a steady stream of reads of similar sizes
+ * allocates nothing.
+ *
+ * Buffers are aligned to a page (or, if hugepages are requested, to
+ * a 2 MiB huge page, which on Linux is also advised as a candidate
+ * for transparent hugepages).
+ */
+class buffer_pool
+{
+public:
+    static constexpr size_t PAGE = 1 << 12;
+    static constexpr size_t HUGE_PAGE = 1 << 21;
+
+    /*
+     * Constructor
+     *
+     * @param capacity The maximum number of idle bytes to keep
+     * @param hugepages Whether to back buffers with huge pages
+     */
+    buffer_pool(size_t capacity, bool hugepages)
+        : m_idle(),
+          m_sizes(),
+          m_capacity(capacity),
+          m_idle_bytes(0),
+          m_hugepages(hugepages),
+          m_lock(PTHREAD_MUTEX_INITIALIZER)
+    {
+    }
+
+    buffer_pool(const buffer_pool &rhs) = delete;
+    buffer_pool &operator=(const buffer_pool &rhs) = delete;
+
+    /*
+     * Destructor.  Idle buffers are freed; buffers that are checked
+     * out are left alone (they may still be in use) and must then be
+     * freed with deallocate.
+     */
+    ~buffer_pool()
+    {
+        for (auto &entry : m_idle)
+        {
+            for (auto buffer : entry.second)
+            {
+                deallocate(buffer);
+            }
+        }
+        pthread_mutex_destroy(&m_lock);
+    }
+
+    /*
+     * Check out a buffer.
+     *
+     * @param size The minimum size of the buffer in bytes
+     * @param capacity The return-location of the actual size of the
+     *                 buffer (may be nullptr)
+     * @return The buffer, or nullptr if it could not be allocated
+     */
+    void *acquire(size_t size, size_t *capacity)
+    {
+        size_t rounded = round_up(size);
+        void *buffer = nullptr;
+
+        pthread_mutex_lock(&m_lock);
+        auto &idle = m_idle[rounded];
+        if (!idle.empty())
+        {
+            buffer = idle.back();
+            idle.pop_back();
+            m_idle_bytes -= rounded;
+        }
+        pthread_mutex_unlock(&m_lock);
+
+        if (buffer == nullptr)
+        {
+            buffer = allocate(rounded);
+            if (buffer == nullptr)
+            {
+                return nullptr;
+            }
+        }
+
+        pthread_mutex_lock(&m_lock);
+        m_sizes[buffer] = rounded;
+        pthread_mutex_unlock(&m_lock);
+
+        if (capacity != nullptr)
+        {
+            *capacity = rounded;
+        }
+        return buffer;
+    }
+
+    /*
+     * Check in a buffer.  If the pool already holds capacity idle
+     * bytes, the buffer is freed instead.
+     *
+     * @param buffer A buffer that was returned by acquire
+     * @return Whether the buffer belonged to this pool
+     */
+    bool release(void *buffer)
+    {
+        bool keep = false;
+
+        pthread_mutex_lock(&m_lock);
+        auto it = m_sizes.find(buffer);
+        if (it == m_sizes.end())
+        {
+            pthread_mutex_unlock(&m_lock);
+            return false;
+        }
+        size_t size = it->second;
+        m_sizes.erase(it);
+        if (m_idle_bytes + size <= m_capacity)
+        {
+            m_idle[size].push_back(buffer);
+            m_idle_bytes += size;
+            keep = true;
+        }
+        pthread_mutex_unlock(&m_lock);
+
+        if (!keep)
+        {
+            deallocate(buffer);
+        }
+        return true;
+    }
+
+    /*
+     * The number of idle bytes held by the pool.
+     */
+    size_t idle_bytes()
+    {
+        pthread_mutex_lock(&m_lock);
+        size_t retval = m_idle_bytes;
+        pthread_mutex_unlock(&m_lock);
+        return retval;
+    }
+
+    /*
+     * Free a buffer that was allocated by a pool.
+     *
+     * @param buffer The buffer
+     */
+    static void deallocate(void *buffer)
+    {
+#if defined(__MINGW32__)
+        _aligned_free(buffer);
+#else
+        free(buffer);
+#endif
+    }
+
+private:
+    static size_t round_up(size_t size)
+    {
+        size_t rounded = PAGE;
+        while (rounded < size)
+        {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    void *allocate(size_t size)
+    {
+        void *buffer = nullptr;
+        size_t alignment = (m_hugepages && size >= HUGE_PAGE) ? HUGE_PAGE : PAGE;
+
+#if defined(__MINGW32__)
+        buffer = _aligned_malloc(size, alignment);
+#else
+        if (posix_memalign(&buffer, alignment, size) != 0)
+        {
+            return nullptr;
+        }
+#endif
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (alignment == HUGE_PAGE)
+        {
+            madvise(buffer, size, MADV_HUGEPAGE);
+        }
+#endif
+        return buffer;
+    }
+
+    std::map<size_t, std::vector<void *>> m_idle;
+    std::map<void *, size_t> m_sizes;
+    size_t m_capacity;
+    size_t m_idle_bytes;
+    bool m_hugepages;
+    pthread_mutex_t m_lock;
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BYTE_ORDER_H__
+#define __BYTE_ORDER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+ * Byte-swapping kernels for converting pixel data between native and
+ * big-endian (JVM) byte order in place.  Each handles sixteen bytes
+ * per step with SSE2 (x86-64) or NEON (AArch64), both of which are
+ * part of the baseline of their architectures, and the remainder one
+ * element at a time.  The data need not be aligned.
+ */
+
+static inline void swap_16(uint8_t *data, size_t count)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + 2 * i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)(data + 2 * i), v);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u8(data + 2 * i, vrev16q_u8(vld1q_u8(data + 2 * i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        uint16_t x;
+        memcpy(&x, data + 2 * i, sizeof(x));
+        x = __builtin_bswap16(x);
+        memcpy(data + 2 * i, &x, sizeof(x));
+    }
+}
+
+static inline void swap_32(uint8_t *data, size_t count)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + 4 * i));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)(data + 4 * i), v);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_u8(data + 4 * i, vrev32q_u8(vld1q_u8(data + 4 * i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        uint32_t x;
+        memcpy(&x, data + 4 * i, sizeof(x));
+        x = __builtin_bswap32(x);
+        memcpy(data + 4 * i, &x, sizeof(x));
+    }
+}
+
+static inline void swap_64(uint8_t *data, size_t count)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + 8 * i));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)(data + 8 * i), v);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 2 <= count; i += 2)
+    {
+        vst1q_u8(data + 8 * i, vrev64q_u8(vld1q_u8(data + 8 * i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        uint64_t x;
+        memcpy(&x, data + 8 * i, sizeof(x));
+        x = __builtin_bswap64(x);
+        memcpy(data + 8 * i, &x, sizeof(x));
+    }
+}
+
+/*
+ * Convert count elements of the given size (1, 2, 4 or 8 bytes)
+ * between native and big-endian byte order in place (a no-op on
+ * big-endian hosts).
+ */
+static inline void swap_big_endian(void *data, size_t count, int size)
+{
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+    switch (size)
+    {
+    case 2:
+        swap_16((uint8_t *)data, count);
+        break;
+    case 4:
+        swap_32((uint8_t *)data, count);
+        break;
+    case 8:
+        swap_64((uint8_t *)data, count);
+        break;
+    }
+#endif
+}
+
+#endif
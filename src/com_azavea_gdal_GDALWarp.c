@@ -17,29 +17,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
-#if defined(__APPLE__)
-#include <arpa/inet.h>
-#define htobe16(x) htons(x)
-#define htobe32(x) htonl(x)
-#define htobe64(x) htonll(x)
-#elif defined(__MINGW32__)
 #include <stdint.h>
-#include <winsock2.h>
-#define htobe16(x) htons(x)
-#define htobe32(x) htonl(x)
-
-uint64_t htobe64(uint64_t x) // Never tested
-{
-    uint64_t retval;
-    uint32_t *p1 = (uint32_t *)&retval;
-    uint32_t *p2 = (uint32_t *)&x;
-    p1[0] = htonl(p2[1]);
-    p1[1] = htonl(p2[0]);
-    return retval;
-}
-#else
-#include <endian.h>
-#endif
 
 #include <gdal.h>
 #include <cpl_conv.h>
@@ -47,18 +25,113 @@ uint64_t htobe64(uint64_t x) // Never tested
 
 #include "com_azavea_gdal_GDALWarp.h"
 #include "bindings.h"
+#include "byte_order.h"
+#include "buffer_layout.h"
 
 const int copies = -4;
 
 const int MAX_OPTIONS = 1 << 10;
 int gc_lock = 0;
+int native_order = 0;
+
+/**
+ * Convert the first length bytes of data from native byte order to
+ * big-endian (the byte order of the JVM) in-place, unless results
+ * are to be left in native byte order (see set_native_order).  The
+ * components of complex types are swapped separately.
+ *
+ * @param type The GDALDataType of the elements of the buffer
+ * @param data The buffer
+ * @param length The number of bytes to convert
+ */
+static void swap_bytes(int type, void *data, jsize length)
+{
+    int size = GDALGetDataTypeSizeBytes(type);
+
+    if (native_order || size <= 1 || length <= 0)
+    {
+        return;
+    }
+    if (GDALDataTypeIsComplex(type))
+    {
+        size /= 2;
+    }
+    swap_big_endian(data, length / size, size);
+}
+
+/**
+ * Convert the elements of a (possibly strided) multi-band buffer to
+ * big-endian in-place, touching only the elements that a read with
+ * the given layout writes.  Elements that are adjacent in memory
+ * (the whole buffer, one line of all bands when the bands are
+ * pixel-interleaved, or one line of one band) are swapped as one run.
+ *
+ * @param type The GDALDataType of the elements of the buffer
+ * @param data The location of the first element
+ * @param width The number of pixels per line
+ * @param height The number of lines per band
+ * @param band_count The number of bands
+ * @param spacing The pixel, line and band spacing in bytes
+ */
+static void swap_bytes_strided(int type, jbyte *data, int width, int height, int band_count,
+                               const int64_t spacing[3])
+{
+    int64_t size = GDALGetDataTypeSizeBytes(type);
+    int band_sequential = (spacing[0] == size && spacing[1] == width * size &&
+                           (band_count == 1 || spacing[2] == height * spacing[1]));
+    int pixel_interleaved = (spacing[2] == size && spacing[0] == band_count * size);
+
+    if (native_order || size <= 1)
+    {
+        return;
+    }
+    if (band_sequential || (pixel_interleaved && spacing[1] == width * spacing[0]))
+    {
+        swap_bytes(type, data, (jsize)(size * width * height * band_count));
+        return;
+    }
+    for (int y = 0; y < height; ++y)
+    {
+        if (pixel_interleaved)
+        {
+            swap_bytes(type, data + y * spacing[1], (jsize)(size * width * band_count));
+            continue;
+        }
+        for (int b = 0; b < band_count; ++b)
+        {
+            jbyte *line = data + b * spacing[2] + y * spacing[1];
+            if (spacing[0] == size)
+            {
+                swap_bytes(type, line, (jsize)(size * width));
+            }
+            else
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    swap_bytes(type, line + x * spacing[0], (jsize)size);
+                }
+            }
+        }
+    }
+}
 
 JNIEXPORT void JNICALL Java_com_azavea_gdal_GDALWarp__1init(JNIEnv *env, jobject obj, jint size)
 {
     gc_lock = (getenv("GDALWARP_GC_LOCK") != NULL); // XXX enabling this might be unsafe but might lead to better performance
+    native_order = (getenv("GDALWARP_NATIVE_ORDER") != NULL);
     init(size);
 }
 
+JNIEXPORT void JNICALL Java_com_azavea_gdal_GDALWarp_set_1native_1order(JNIEnv *env, jclass obj, jboolean _native_order)
+{
+    native_order = (_native_order == JNI_TRUE);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_azavea_gdal_GDALWarp_get_1native_1order(JNIEnv *env, jclass obj)
+{
+    return native_order ? JNI_TRUE : JNI_FALSE;
+}
+
 JNIEXPORT void JNICALL Java_com_azavea_gdal_GDALWarp_deinit(JNIEnv *env, jobject obj)
 {
     deinit();
@@ -125,21 +198,21 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1block_1size(JNIEnv *en
     jint *width = (*env)->GetIntArrayElements(env, _width, NULL);
     jint *height = (*env)->GetIntArrayElements(env, _height, NULL);
 
-    jint retval = get_block_size(token, dataset, attempts, copies, band_number, (int *)width, (int *)height);
+    jint retval = get_block_size(token, dataset, attempts, 0, copies, band_number, (int *)width, (int *)height);
     (*env)->ReleaseIntArrayElements(env, _width, width, 0);
     (*env)->ReleaseIntArrayElements(env, _height, height, 0);
 
     return retval;
 }
 
-JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1histogram(JNIEnv *env, jclass obj, jlong token, jint dataset, jint attempts, jint band_number,
-                                                                    jdouble lower, jdouble upper, jlongArray _hist, jboolean include_out_of_range,
-                                                                    jboolean approx_ok)
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1histogram(JNIEnv *env, jclass obj, jlong token, jint dataset, jint attempts, jint band_number,
+                                                                     jdouble lower, jdouble upper, jlongArray _hist, jboolean include_out_of_range,
+                                                                     jboolean approx_ok, jlong nanos)
 {
     jlong *hist = (*env)->GetLongArrayElements(env, _hist, NULL);
     jint num_buckets = (*env)->GetArrayLength(env, _hist);
 
-    jint retval = get_histogram(token, dataset, attempts, copies, band_number,
+    jint retval = get_histogram(token, dataset, attempts, nanos, copies, band_number,
                                 lower, upper, num_buckets, (unsigned long long int *)hist,
                                 include_out_of_range, approx_ok);
     (*env)->ReleaseLongArrayElements(env, _hist, hist, 0);
@@ -158,7 +231,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1offset(JNIEnv *env, jc
     jdouble *offset = (*env)->GetDoubleArrayElements(env, _offset, NULL);
     jint *success = (*env)->GetIntArrayElements(env, _success, NULL);
 
-    jint retval = get_offset(token, dataset, attempts, copies, band_number, offset, (int *)success);
+    jint retval = get_offset(token, dataset, attempts, 0, copies, band_number, offset, (int *)success);
     (*env)->ReleaseIntArrayElements(env, _success, success, 0);
     (*env)->ReleaseDoubleArrayElements(env, _offset, offset, 0);
 
@@ -176,7 +249,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1scale(JNIEnv *env, jcl
     jdouble *scale = (*env)->GetDoubleArrayElements(env, _scale, NULL);
     jint *success = (*env)->GetIntArrayElements(env, _success, NULL);
 
-    jint retval = get_scale(token, dataset, attempts, copies, band_number, scale, (int *)success);
+    jint retval = get_scale(token, dataset, attempts, 0, copies, band_number, scale, (int *)success);
     (*env)->ReleaseIntArrayElements(env, _success, success, 0);
     (*env)->ReleaseDoubleArrayElements(env, _scale, scale, 0);
 
@@ -188,7 +261,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_noop(JNIEnv *env, jclass ob
                                                           jint dataset,
                                                           jint attempts)
 {
-    return noop(token, dataset, attempts, copies);
+    return noop(token, dataset, attempts, 0, copies);
 }
 
 JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1color_1interpretation(JNIEnv *env, jclass obj,
@@ -200,21 +273,22 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1color_1interpretation(
 {
     jint *color_interp = (*env)->GetIntArrayElements(env, _color_interp, NULL);
 
-    jint retval = get_color_interpretation(token, dataset, attempts, copies, band_number, (int *)color_interp);
+    jint retval = get_color_interpretation(token, dataset, attempts, 0, copies, band_number, (int *)color_interp);
     (*env)->ReleaseIntArrayElements(env, _color_interp, color_interp, 0);
 
     return retval;
 }
 
-JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1metadata_1domain_1list(JNIEnv *env, jclass obj,
-                                                                                 jlong token,
-                                                                                 jint dataset,
-                                                                                 jint attempts,
-                                                                                 jint band_number,
-                                                                                 jobjectArray _domain_list)
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1metadata_1domain_1list(JNIEnv *env, jclass obj,
+                                                                                  jlong token,
+                                                                                  jint dataset,
+                                                                                  jint attempts,
+                                                                                  jint band_number,
+                                                                                  jobjectArray _domain_list,
+                                                                                  jlong nanos)
 {
     char **domain_list = NULL;
-    jint retval = get_metadata_domain_list(token, dataset, attempts, copies, band_number, &domain_list);
+    jint retval = get_metadata_domain_list(token, dataset, attempts, nanos, copies, band_number, &domain_list);
     if (retval < 0)
     {
         return retval;
@@ -270,12 +344,12 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1metadata_1domain_1list
     }
 }
 
-JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1metadata(JNIEnv *env, jclass obj,
-                                                                   jlong token, jint dataset, jint attempts, jint band_number, jstring _domain, jobjectArray _list)
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1metadata(JNIEnv *env, jclass obj,
+                                                                    jlong token, jint dataset, jint attempts, jint band_number, jstring _domain, jobjectArray _list, jlong nanos)
 {
     const char *domain = (*env)->GetStringUTFChars(env, _domain, NULL);
     char **list = NULL;
-    jint retval = get_metadata(token, dataset, attempts, copies, band_number, domain, &list);
+    jint retval = get_metadata(token, dataset, attempts, nanos, copies, band_number, domain, &list);
     if (retval < 0)
     {
         return retval;
@@ -329,15 +403,15 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1metadata(JNIEnv *env,
     }
 }
 
-JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1metadata_1item(JNIEnv *env, jclass obj,
-                                                                         jlong token, jint dataset, jint attempts, jint band_number, jstring _key, jstring _domain, jbyteArray _value)
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1metadata_1item(JNIEnv *env, jclass obj,
+                                                                          jlong token, jint dataset, jint attempts, jint band_number, jstring _key, jstring _domain, jbyteArray _value, jlong nanos)
 {
     const char *key = (*env)->GetStringUTFChars(env, _key, NULL);
     const char *domain = (*env)->GetStringUTFChars(env, _domain, NULL);
     jsize max_size = (*env)->GetArrayLength(env, _value);
     const char *value_src = NULL;
     jbyte *bytes = (*env)->GetByteArrayElements(env, _value, NULL);
-    jint retval = get_metadata_item(token, dataset, attempts, copies, band_number, key, domain, &value_src);
+    jint retval = get_metadata_item(token, dataset, attempts, nanos, copies, band_number, key, domain, &value_src);
 
     if (retval < 0)
     {
@@ -377,7 +451,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1overview_1widths_1heig
     jsize width_length = (*env)->GetArrayLength(env, _widths);
     jsize height_length = (*env)->GetArrayLength(env, _heights);
     int max_length = width_length < height_length ? width_length : height_length;
-    jint retval = get_overview_widths_heights(token, dataset, attempts, copies, band_number, (int *)widths, (int *)heights, max_length);
+    jint retval = get_overview_widths_heights(token, dataset, attempts, 0, copies, band_number, (int *)widths, (int *)heights, max_length);
     (*env)->ReleaseIntArrayElements(env, _heights, heights, 0);
     (*env)->ReleaseIntArrayElements(env, _widths, widths, 0);
 
@@ -392,7 +466,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1crs_1proj4(JNIEnv *env
 {
     jbyte *crs = (*env)->GetByteArrayElements(env, _crs, NULL);
     jsize max_size = (*env)->GetArrayLength(env, _crs);
-    jint retval = get_crs_proj4(token, dataset, attempts, copies, (char *)crs, max_size);
+    jint retval = get_crs_proj4(token, dataset, attempts, 0, copies, (char *)crs, max_size);
     (*env)->ReleaseByteArrayElements(env, _crs, crs, 0);
 
     return retval;
@@ -406,7 +480,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1crs_1wkt(JNIEnv *env,
 {
     jbyte *crs = (*env)->GetByteArrayElements(env, _crs, NULL);
     jsize max_size = (*env)->GetArrayLength(env, _crs);
-    jint retval = get_crs_wkt(token, dataset, attempts, copies, (char *)crs, max_size);
+    jint retval = get_crs_wkt(token, dataset, attempts, 0, copies, (char *)crs, max_size);
     (*env)->ReleaseByteArrayElements(env, _crs, crs, 0);
 
     return retval;
@@ -422,31 +496,75 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1band_1nodata(JNIEnv *e
 {
     double *nodata = (*env)->GetDoubleArrayElements(env, _nodata, NULL);
     jint *success = (*env)->GetIntArrayElements(env, _success, NULL);
-    jint retval = get_band_nodata(token, dataset, attempts, copies, band, nodata, (int *)success);
+    jint retval = get_band_nodata(token, dataset, attempts, 0, copies, band, nodata, (int *)success);
     (*env)->ReleaseIntArrayElements(env, _success, success, 0);
     (*env)->ReleaseDoubleArrayElements(env, _nodata, nodata, 0);
 
     return retval;
 }
 
-JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1band_1min_1max(JNIEnv *env, jclass obj,
-                                                                         jlong token,
-                                                                         jint dataset,
-                                                                         jint attempts,
-                                                                         jint band,
-                                                                         jboolean approx_okay,
-                                                                         jdoubleArray _minmax,
-                                                                         jintArray _success)
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1band_1min_1max(JNIEnv *env, jclass obj,
+                                                                          jlong token,
+                                                                          jint dataset,
+                                                                          jint attempts,
+                                                                          jint band,
+                                                                          jboolean approx_okay,
+                                                                          jdoubleArray _minmax,
+                                                                          jintArray _success,
+                                                                          jlong nanos)
 {
     double *minmax = (*env)->GetDoubleArrayElements(env, _minmax, NULL);
     jint *success = (*env)->GetIntArrayElements(env, _success, NULL);
-    jint retval = get_band_min_max(token, dataset, attempts, copies, band, approx_okay, minmax, (int *)success);
+    jint retval = get_band_min_max(token, dataset, attempts, nanos, copies, band, approx_okay, minmax, (int *)success);
     (*env)->ReleaseIntArrayElements(env, _success, success, 0);
     (*env)->ReleaseDoubleArrayElements(env, _minmax, minmax, 0);
 
     return retval;
 }
 
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1statistics(JNIEnv *env, jclass obj,
+                                                                        jlong token,
+                                                                        jint dataset,
+                                                                        jint attempts,
+                                                                        jint band,
+                                                                        jboolean approx_ok,
+                                                                        jdoubleArray _percentiles,
+                                                                        jdoubleArray _percentile_values,
+                                                                        jdoubleArray _statistics,
+                                                                        jlong nanos)
+{
+    jsize percentile_count = (_percentiles != NULL) ? (*env)->GetArrayLength(env, _percentiles) : 0;
+    if (_statistics == NULL || (*env)->GetArrayLength(env, _statistics) < 5 ||
+        (percentile_count > 0 && (_percentile_values == NULL || (*env)->GetArrayLength(env, _percentile_values) < percentile_count)))
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jdouble *percentiles = NULL;
+    jdouble *percentile_values = NULL;
+    statistics_t statistics;
+    if (percentile_count > 0)
+    {
+        percentiles = (*env)->GetDoubleArrayElements(env, _percentiles, NULL);
+        percentile_values = (*env)->GetDoubleArrayElements(env, _percentile_values, NULL);
+    }
+    jint retval = get_statistics(token, dataset, attempts, nanos, copies, band, approx_ok,
+                                 percentile_count, percentiles, percentile_values, &statistics);
+    if (percentile_count > 0)
+    {
+        (*env)->ReleaseDoubleArrayElements(env, _percentile_values, percentile_values, 0);
+        (*env)->ReleaseDoubleArrayElements(env, _percentiles, percentiles, JNI_ABORT);
+    }
+    if (retval > 0)
+    {
+        jdouble values[5] = {(jdouble)statistics.valid_count, statistics.minimum, statistics.maximum,
+                             statistics.mean, statistics.stddev};
+        (*env)->SetDoubleArrayRegion(env, _statistics, 0, 5, values);
+    }
+
+    return retval;
+}
+
 JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1band_1data_1type(JNIEnv *env, jclass obj,
                                                                            jlong token,
                                                                            jint dataset,
@@ -455,7 +573,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1band_1data_1type(JNIEn
                                                                            jintArray _data_type)
 {
     jint *data_type = (*env)->GetIntArrayElements(env, _data_type, NULL);
-    jint retval = get_band_data_type(token, dataset, attempts, copies, band, (int *)data_type);
+    jint retval = get_band_data_type(token, dataset, attempts, 0, copies, band, (int *)data_type);
     (*env)->ReleaseIntArrayElements(env, _data_type, data_type, 0);
 
     return retval;
@@ -468,7 +586,7 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1band_1count(JNIEnv *en
                                                                       jintArray _band_count)
 {
     jint *band_count = (*env)->GetIntArrayElements(env, _band_count, NULL);
-    jint retval = get_band_count(token, dataset, attempts, copies, (int *)band_count);
+    jint retval = get_band_count(token, dataset, attempts, 0, copies, (int *)band_count);
     (*env)->ReleaseIntArrayElements(env, _band_count, band_count, 0);
 
     return retval;
@@ -482,21 +600,22 @@ jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1width_1height(JNIEnv *env, jclas
 {
     jint *width_height = (*env)->GetIntArrayElements(env, _width_height, NULL);
 
-    jint retval = get_width_height(token, dataset, attempts, copies, (int *)width_height, (int *)(width_height + 1));
+    jint retval = get_width_height(token, dataset, attempts, 0, copies, (int *)width_height, (int *)(width_height + 1));
     (*env)->ReleaseIntArrayElements(env, _width_height, width_height, 0);
 
     return retval;
 }
 
-JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1data(JNIEnv *env, jobject obj,
-                                                               jlong token,
-                                                               jint dataset,
-                                                               jint attempts,
-                                                               jintArray _src_window,
-                                                               jintArray _dst_window,
-                                                               jint band_number,
-                                                               jint type,
-                                                               jbyteArray _data)
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data(JNIEnv *env, jobject obj,
+                                                                 jlong token,
+                                                                 jint dataset,
+                                                                 jint attempts,
+                                                                 jintArray _src_window,
+                                                                 jintArray _dst_window,
+                                                                 jint band_number,
+                                                                 jint type,
+                                                                 jbyteArray _data,
+                                                                 jlong nanos)
 {
     jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
     jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
@@ -511,36 +630,12 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1data(JNIEnv *env, jobj
     {
         data = (*env)->GetByteArrayElements(env, _data, NULL);
     }
-    jint retval = get_data(token, dataset, attempts, 0, copies, (int *)src_window, (int *)dst_window, band_number, type, data);
-    switch (type)
+    jint retval = get_data(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, band_number, type, data);
+    if (retval > 0)
     {
-    case com_azavea_gdal_GDALWarp_GDT_Int16:
-    case com_azavea_gdal_GDALWarp_GDT_UInt16:
-    case com_azavea_gdal_GDALWarp_GDT_CInt16:
-        for (int i = 0; i <= length - sizeof(uint16_t); i += sizeof(uint16_t))
-        {
-            uint16_t *ptr = (uint16_t *)(data + i);
-            *ptr = htobe16(*ptr);
-        }
-        break;
-    case com_azavea_gdal_GDALWarp_GDT_Int32:
-    case com_azavea_gdal_GDALWarp_GDT_UInt32:
-    case com_azavea_gdal_GDALWarp_GDT_CInt32:
-    case com_azavea_gdal_GDALWarp_GDT_Float32:
-    case com_azavea_gdal_GDALWarp_GDT_CFloat32:
-        for (int i = 0; i <= length - sizeof(uint32_t); i += sizeof(uint32_t))
-        {
-            uint32_t *ptr = (uint32_t *)(data + i);
-            *ptr = htobe32(*ptr);
-        }
-        break;
-    case com_azavea_gdal_GDALWarp_GDT_Float64:
-    case com_azavea_gdal_GDALWarp_GDT_CFloat64:
-        for (int i = 0; i <= length - sizeof(uint64_t); i += sizeof(uint64_t))
-        {
-            uint64_t *ptr = (uint64_t *)(data + i);
-            *ptr = htobe64(*ptr);
-        }
+        // Only the part of the array that was written
+        int64_t written = (int64_t)dst_window[0] * dst_window[1] * GDALGetDataTypeSizeBytes(type);
+        swap_bytes(type, data, (jsize)(written < length ? written : length));
     }
     if (gc_lock)
     {
@@ -563,8 +658,866 @@ JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_get_1transform(JNIEnv *env,
                                                                     jdoubleArray _transform)
 {
     double *transform = (*env)->GetDoubleArrayElements(env, _transform, NULL);
-    jint retval = get_transform(token, dataset, attempts, copies, transform);
+    jint retval = get_transform(token, dataset, attempts, 0, copies, transform);
     (*env)->ReleaseDoubleArrayElements(env, _transform, transform, 0);
 
     return retval;
 }
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1info(JNIEnv *env, jclass obj,
+                                                                 jlong token,
+                                                                 jint dataset,
+                                                                 jint attempts,
+                                                                 jbyteArray _info)
+{
+    jbyte *info = (*env)->GetByteArrayElements(env, _info, NULL);
+    jsize max_size = (*env)->GetArrayLength(env, _info);
+    jint retval = get_info(token, dataset, attempts, 0, copies, info, max_size);
+
+    // The size field of the header is the required size of the array
+    if (retval >= 0 && ((info_header_t *)info)->size > max_size)
+    {
+        retval = -CPLE_AppDefined;
+    }
+    (*env)->ReleaseByteArrayElements(env, _info, info, 0);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1ex(JNIEnv *env, jclass obj,
+                                                                     jlong token,
+                                                                     jint dataset,
+                                                                     jint attempts,
+                                                                     jintArray _src_window,
+                                                                     jintArray _dst_window,
+                                                                     jintArray _band_list,
+                                                                     jint interleave,
+                                                                     jint type,
+                                                                     jbyteArray _data,
+                                                                     jint offset,
+                                                                     jlong pixel_space,
+                                                                     jlong line_space,
+                                                                     jlong band_space,
+                                                                     jint overview,
+                                                                     jint resampling,
+                                                                     jdoubleArray _fractional_window,
+                                                                     jbyteArray _mask,
+                                                                     jboolean mask_packed,
+                                                                     jlong nanos)
+{
+    if (_band_list == NULL ||
+        (_fractional_window != NULL && (*env)->GetArrayLength(env, _fractional_window) < 4))
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    jsize length = (*env)->GetArrayLength(env, _data);
+    int64_t spacing[3] = {pixel_space, line_space, band_space};
+    jint retval = -CPLE_IllegalArg;
+
+    if (resolve_spacing(interleave, type, dst_window[0], dst_window[1], band_count, spacing) &&
+        fits(offset, type, dst_window[0], dst_window[1], band_count, spacing, length) &&
+        (_mask == NULL ||
+         (*env)->GetArrayLength(env, _mask) >= MASK_BYTES(dst_window[0], dst_window[1], mask_packed)))
+    {
+        read_options_t options;
+        jbyte *data = NULL;
+        jbyte *mask = NULL;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+        options.pixel_space = spacing[0];
+        options.line_space = spacing[1];
+        options.band_space = spacing[2];
+        options.overview = overview;
+        options.resampling = resampling;
+        if (_fractional_window != NULL)
+        {
+            options.has_fractional_window = 1;
+            (*env)->GetDoubleArrayRegion(env, _fractional_window, 0, 4, options.fractional_window);
+        }
+        // Pinned before (and released after) any critical section
+        if (_mask != NULL)
+        {
+            mask = (*env)->GetByteArrayElements(env, _mask, NULL);
+            options.mask = (uint8_t *)mask;
+            options.mask_packed = mask_packed;
+        }
+
+        if (gc_lock)
+        {
+            data = (*env)->GetPrimitiveArrayCritical(env, _data, NULL);
+        }
+        else
+        {
+            data = (*env)->GetByteArrayElements(env, _data, NULL);
+        }
+        retval = get_data_ex(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, type, data + offset, &options);
+        if (retval > 0)
+        {
+            swap_bytes_strided(type, data + offset, dst_window[0], dst_window[1], band_count, spacing);
+        }
+        if (gc_lock)
+        {
+            (*env)->ReleasePrimitiveArrayCritical(env, _data, data, 0);
+        }
+        else
+        {
+            (*env)->ReleaseByteArrayElements(env, _data, data, 0);
+        }
+        if (mask != NULL)
+        {
+            (*env)->ReleaseByteArrayElements(env, _mask, mask, 0);
+        }
+    }
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_window, dst_window, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1direct(JNIEnv *env, jclass obj,
+                                                                         jlong token,
+                                                                         jint dataset,
+                                                                         jint attempts,
+                                                                         jintArray _src_window,
+                                                                         jintArray _dst_window,
+                                                                         jintArray _band_list,
+                                                                         jint interleave,
+                                                                         jint type,
+                                                                         jobject _data,
+                                                                         jint offset,
+                                                                         jlong nanos)
+{
+    jbyte *data = (_data != NULL) ? (*env)->GetDirectBufferAddress(env, _data) : NULL;
+    if (_band_list == NULL || data == NULL)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    jlong capacity = (*env)->GetDirectBufferCapacity(env, _data);
+    int64_t spacing[3] = {0, 0, 0};
+    jint retval = -CPLE_IllegalArg;
+
+    if (resolve_spacing(interleave, type, dst_window[0], dst_window[1], band_count, spacing) &&
+        fits(offset, type, dst_window[0], dst_window[1], band_count, spacing, capacity))
+    {
+        read_options_t options;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+        options.pixel_space = spacing[0];
+        options.line_space = spacing[1];
+        options.band_space = spacing[2];
+
+        // GDAL writes straight into the buffer, which is left in native byte order
+        retval = get_data_ex(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, type, data + offset, &options);
+    }
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_window, dst_window, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+
+    return retval;
+}
+
+/**
+ * Read pixel data, band-sequentially, straight into a typed Java
+ * array (short[], int[], float[] or double[]).  The elements of the
+ * GDAL buffer type (or its components, for complex types) must be
+ * the size of those of the array; the values are left in native byte
+ * order, which is the order of the elements of a Java array.
+ *
+ * @param kind The JNI signature character of the array elements
+ *             ('S', 'I', 'F' or 'D')
+ * @param element_size The size in bytes of the array elements
+ * @return The number of attempts on success, negative CPLErrorNum on failure
+ */
+static jint get_data_typed(JNIEnv *env,
+                           jlong token,
+                           jint dataset,
+                           jint attempts,
+                           jintArray _src_window,
+                           jintArray _dst_window,
+                           jintArray _band_list,
+                           jint type,
+                           jarray _data,
+                           char kind,
+                           int element_size,
+                           jlong nanos)
+{
+    if (_band_list == NULL || _data == NULL || !element_size_matches(type, element_size))
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    int64_t length = (int64_t)(*env)->GetArrayLength(env, _data) * element_size;
+    int64_t spacing[3] = {0, 0, 0};
+    jint retval = -CPLE_IllegalArg;
+
+    if (resolve_spacing(INTERLEAVE_BAND, type, dst_window[0], dst_window[1], band_count, spacing) &&
+        fits(0, type, dst_window[0], dst_window[1], band_count, spacing, length))
+    {
+        read_options_t options;
+        void *data = NULL;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+
+        if (gc_lock)
+        {
+            data = (*env)->GetPrimitiveArrayCritical(env, _data, NULL);
+        }
+        else
+        {
+            switch (kind)
+            {
+            case 'S':
+                data = (*env)->GetShortArrayElements(env, (jshortArray)_data, NULL);
+                break;
+            case 'I':
+                data = (*env)->GetIntArrayElements(env, (jintArray)_data, NULL);
+                break;
+            case 'F':
+                data = (*env)->GetFloatArrayElements(env, (jfloatArray)_data, NULL);
+                break;
+            case 'D':
+                data = (*env)->GetDoubleArrayElements(env, (jdoubleArray)_data, NULL);
+                break;
+            }
+        }
+        retval = get_data_ex(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, type, data, &options);
+        if (gc_lock)
+        {
+            (*env)->ReleasePrimitiveArrayCritical(env, _data, data, 0);
+        }
+        else
+        {
+            switch (kind)
+            {
+            case 'S':
+                (*env)->ReleaseShortArrayElements(env, (jshortArray)_data, data, 0);
+                break;
+            case 'I':
+                (*env)->ReleaseIntArrayElements(env, (jintArray)_data, data, 0);
+                break;
+            case 'F':
+                (*env)->ReleaseFloatArrayElements(env, (jfloatArray)_data, data, 0);
+                break;
+            case 'D':
+                (*env)->ReleaseDoubleArrayElements(env, (jdoubleArray)_data, data, 0);
+                break;
+            }
+        }
+    }
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_window, dst_window, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1short(JNIEnv *env, jclass obj,
+                                                                        jlong token,
+                                                                        jint dataset,
+                                                                        jint attempts,
+                                                                        jintArray _src_window,
+                                                                        jintArray _dst_window,
+                                                                        jintArray _band_list,
+                                                                        jint type,
+                                                                        jshortArray _data,
+                                                                        jlong nanos)
+{
+    return get_data_typed(env, token, dataset, attempts, _src_window, _dst_window, _band_list, type,
+                          _data, 'S', sizeof(jshort), nanos);
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1int(JNIEnv *env, jclass obj,
+                                                                      jlong token,
+                                                                      jint dataset,
+                                                                      jint attempts,
+                                                                      jintArray _src_window,
+                                                                      jintArray _dst_window,
+                                                                      jintArray _band_list,
+                                                                      jint type,
+                                                                      jintArray _data,
+                                                                      jlong nanos)
+{
+    return get_data_typed(env, token, dataset, attempts, _src_window, _dst_window, _band_list, type,
+                          _data, 'I', sizeof(jint), nanos);
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1float(JNIEnv *env, jclass obj,
+                                                                        jlong token,
+                                                                        jint dataset,
+                                                                        jint attempts,
+                                                                        jintArray _src_window,
+                                                                        jintArray _dst_window,
+                                                                        jintArray _band_list,
+                                                                        jint type,
+                                                                        jfloatArray _data,
+                                                                        jlong nanos)
+{
+    return get_data_typed(env, token, dataset, attempts, _src_window, _dst_window, _band_list, type,
+                          _data, 'F', sizeof(jfloat), nanos);
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1double(JNIEnv *env, jclass obj,
+                                                                         jlong token,
+                                                                         jint dataset,
+                                                                         jint attempts,
+                                                                         jintArray _src_window,
+                                                                         jintArray _dst_window,
+                                                                         jintArray _band_list,
+                                                                         jint type,
+                                                                         jdoubleArray _data,
+                                                                         jlong nanos)
+{
+    return get_data_typed(env, token, dataset, attempts, _src_window, _dst_window, _band_list, type,
+                          _data, 'D', sizeof(jdouble), nanos);
+}
+
+JNIEXPORT jobject JNICALL Java_com_azavea_gdal_GDALWarp__1acquire_1buffer(JNIEnv *env, jclass obj,
+                                                                          jlong size)
+{
+    int64_t capacity = 0;
+    void *buffer = acquire_buffer(size, &capacity);
+    jobject retval = NULL;
+
+    // A ByteBuffer holds at most 2^31 - 1 bytes
+    if (buffer != NULL && capacity <= INT32_MAX)
+    {
+        retval = (*env)->NewDirectByteBuffer(env, buffer, capacity);
+    }
+    if (buffer != NULL && retval == NULL)
+    {
+        release_buffer(buffer);
+    }
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp_release_1buffer(JNIEnv *env, jclass obj,
+                                                                     jobject _buffer)
+{
+    void *buffer = (_buffer != NULL) ? (*env)->GetDirectBufferAddress(env, _buffer) : NULL;
+
+    return release_buffer(buffer);
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1arrow(JNIEnv *env, jclass obj,
+                                                                        jlong token,
+                                                                        jint dataset,
+                                                                        jint attempts,
+                                                                        jintArray _src_window,
+                                                                        jintArray _dst_window,
+                                                                        jintArray _band_list,
+                                                                        jint type,
+                                                                        jboolean validity,
+                                                                        jlong array_address,
+                                                                        jlong schema_address,
+                                                                        jlong nanos)
+{
+    if (array_address == 0 || schema_address == 0)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
+    jint *band_list = NULL;
+    read_options_t options;
+
+    INIT_READ_OPTIONS(options);
+    if (_band_list != NULL)
+    {
+        band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+        options.band_count = (*env)->GetArrayLength(env, _band_list);
+        options.band_list = (int *)band_list;
+    }
+    jint retval = get_data_arrow(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, type, &options, validity,
+                                 (struct ArrowArray *)(intptr_t)array_address, (struct ArrowSchema *)(intptr_t)schema_address);
+    if (_band_list != NULL)
+    {
+        (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    }
+    (*env)->ReleaseIntArrayElements(env, _dst_window, dst_window, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1data_1batch(JNIEnv *env, jclass obj,
+                                                                        jlong token,
+                                                                        jint dataset,
+                                                                        jint attempts,
+                                                                        jintArray _src_windows,
+                                                                        jintArray _dst_windows,
+                                                                        jintArray _band_list,
+                                                                        jint interleave,
+                                                                        jint type,
+                                                                        jobjectArray _data,
+                                                                        jlong nanos)
+{
+    if (_band_list == NULL || _data == NULL)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jsize count = (*env)->GetArrayLength(env, _data);
+    if ((*env)->GetArrayLength(env, _src_windows) < 4 * count ||
+        (*env)->GetArrayLength(env, _dst_windows) < 2 * count)
+    {
+        return -CPLE_IllegalArg;
+    }
+    if ((*env)->EnsureLocalCapacity(env, count) != 0)
+    {
+        return -CPLE_OutOfMemory;
+    }
+
+    jint *src_windows = (*env)->GetIntArrayElements(env, _src_windows, NULL);
+    jint *dst_windows = (*env)->GetIntArrayElements(env, _dst_windows, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    jbyteArray *arrays = calloc(count, sizeof(jbyteArray));
+    jbyte **data = calloc(count, sizeof(jbyte *));
+    jint retval = -CPLE_IllegalArg;
+    jsize i;
+
+    if (count > 0 && (arrays == NULL || data == NULL))
+    {
+        retval = -CPLE_OutOfMemory;
+        goto done;
+    }
+
+    // Collect (and check the sizes of) all of the arrays before
+    // pinning any of them, since no other JNI calls are allowed
+    // while critical arrays are held
+    for (i = 0; i < count; ++i)
+    {
+        int64_t spacing[3] = {0, 0, 0};
+        arrays[i] = (*env)->GetObjectArrayElement(env, _data, i);
+        if (arrays[i] == NULL ||
+            !resolve_spacing(interleave, type, dst_windows[2 * i], dst_windows[2 * i + 1], band_count, spacing) ||
+            !fits(0, type, dst_windows[2 * i], dst_windows[2 * i + 1], band_count, spacing,
+                  (*env)->GetArrayLength(env, arrays[i])))
+        {
+            goto done;
+        }
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        if (gc_lock)
+        {
+            data[i] = (*env)->GetPrimitiveArrayCritical(env, arrays[i], NULL);
+        }
+        else
+        {
+            data[i] = (*env)->GetByteArrayElements(env, arrays[i], NULL);
+        }
+    }
+
+    {
+        read_options_t options;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+        options.interleave = interleave;
+        retval = get_data_batch(token, dataset, attempts, nanos, copies, count, (int *)src_windows, (int *)dst_windows, type, (void *const *)data, &options);
+    }
+
+    for (i = count - 1; i >= 0; --i)
+    {
+        if (retval > 0)
+        {
+            // Bounded by the length of the array (see fits above)
+            int64_t length = (int64_t)dst_windows[2 * i] * dst_windows[2 * i + 1] * band_count * GDALGetDataTypeSizeBytes(type);
+            swap_bytes(type, data[i], (jsize)length);
+        }
+        if (gc_lock)
+        {
+            (*env)->ReleasePrimitiveArrayCritical(env, arrays[i], data[i], 0);
+        }
+        else
+        {
+            (*env)->ReleaseByteArrayElements(env, arrays[i], data[i], 0);
+        }
+    }
+
+done:
+    for (i = 0; i < count && arrays != NULL; ++i)
+    {
+        if (arrays[i] != NULL)
+        {
+            (*env)->DeleteLocalRef(env, arrays[i]);
+        }
+    }
+    free(data);
+    free(arrays);
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_windows, dst_windows, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_windows, src_windows, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1mosaic(JNIEnv *env, jclass obj,
+                                                                   jlongArray _tokens,
+                                                                   jint attempts,
+                                                                   jdoubleArray _dst_extent,
+                                                                   jintArray _dst_size,
+                                                                   jintArray _band_list,
+                                                                   jint type,
+                                                                   jbyteArray _data,
+                                                                   jlong nanos)
+{
+    if (_tokens == NULL || _band_list == NULL)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jlong *tokens = (*env)->GetLongArrayElements(env, _tokens, NULL);
+    jsize count = (*env)->GetArrayLength(env, _tokens);
+    jdouble *dst_extent = (*env)->GetDoubleArrayElements(env, _dst_extent, NULL);
+    jint *dst_size = (*env)->GetIntArrayElements(env, _dst_size, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    jsize length = (*env)->GetArrayLength(env, _data);
+    jlong required = (jlong)dst_size[0] * dst_size[1] * band_count * GDALGetDataTypeSizeBytes(type);
+    jint retval = -CPLE_IllegalArg;
+
+    if (dst_size[0] > 0 && dst_size[1] > 0 && required <= length)
+    {
+        read_options_t options;
+        jbyte *data = NULL;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+
+        if (gc_lock)
+        {
+            data = (*env)->GetPrimitiveArrayCritical(env, _data, NULL);
+        }
+        else
+        {
+            data = (*env)->GetByteArrayElements(env, _data, NULL);
+        }
+        // Pixels that no token covers keep their initial values, so
+        // bring the whole buffer into native order and back
+        swap_bytes(type, data, (jsize)required);
+        retval = get_mosaic((uint64_t *)tokens, count, attempts, nanos, copies, dst_extent, (int *)dst_size, type, data, &options);
+        swap_bytes(type, data, (jsize)required);
+        if (gc_lock)
+        {
+            (*env)->ReleasePrimitiveArrayCritical(env, _data, data, 0);
+        }
+        else
+        {
+            (*env)->ReleaseByteArrayElements(env, _data, data, 0);
+        }
+    }
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_size, dst_size, JNI_ABORT);
+    (*env)->ReleaseDoubleArrayElements(env, _dst_extent, dst_extent, JNI_ABORT);
+    (*env)->ReleaseLongArrayElements(env, _tokens, tokens, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1prefetch(JNIEnv *env, jclass obj,
+                                                                jlong token,
+                                                                jint dataset,
+                                                                jint attempts,
+                                                                jintArray _src_window,
+                                                                jintArray _band_list,
+                                                                jboolean warm,
+                                                                jlong nanos)
+{
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *band_list = NULL;
+    jsize band_count = 0;
+    jint retval;
+
+    if (_band_list != NULL)
+    {
+        band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+        band_count = (*env)->GetArrayLength(env, _band_list);
+    }
+    retval = prefetch(token, dataset, attempts, nanos, copies, (int *)src_window, band_count, (int *)band_list, warm);
+    if (_band_list != NULL)
+    {
+        (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    }
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jlong JNICALL Java_com_azavea_gdal_GDALWarp__1submit_1get_1data(JNIEnv *env, jclass obj,
+                                                                          jlong token,
+                                                                          jint dataset,
+                                                                          jint attempts,
+                                                                          jintArray _src_window,
+                                                                          jintArray _dst_window,
+                                                                          jintArray _band_list,
+                                                                          jint interleave,
+                                                                          jint type,
+                                                                          jobject _data,
+                                                                          jlong nanos)
+{
+    void *data = (_data != NULL) ? (*env)->GetDirectBufferAddress(env, _data) : NULL;
+    if (_band_list == NULL || data == NULL)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    jlong capacity = (*env)->GetDirectBufferCapacity(env, _data);
+    int64_t spacing[3] = {0, 0, 0};
+    jlong retval = -CPLE_IllegalArg;
+
+    if (resolve_spacing(interleave, type, dst_window[0], dst_window[1], band_count, spacing) &&
+        fits(0, type, dst_window[0], dst_window[1], band_count, spacing, capacity))
+    {
+        read_options_t options;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+        options.pixel_space = spacing[0];
+        options.line_space = spacing[1];
+        options.band_space = spacing[2];
+
+        // The global reference keeps the buffer alive until the result is polled
+        jobject tag = (*env)->NewGlobalRef(env, _data);
+        retval = submit_get_data(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, type, data, &options, NULL, tag);
+        if (retval < 0)
+        {
+            (*env)->DeleteGlobalRef(env, tag);
+        }
+    }
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_window, dst_window, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1poll_1completions(JNIEnv *env, jclass obj,
+                                                                        jlongArray _ids,
+                                                                        jintArray _results,
+                                                                        jlong wait_nanos)
+{
+    jsize max_count = (*env)->GetArrayLength(env, _ids);
+    if ((*env)->GetArrayLength(env, _results) < max_count)
+    {
+        return -CPLE_IllegalArg;
+    }
+    if (max_count == 0)
+    {
+        return 0;
+    }
+
+    int64_t *ids = malloc(sizeof(int64_t) * max_count);
+    int *results = malloc(sizeof(int) * max_count);
+    void **tags = malloc(sizeof(void *) * max_count);
+    jint count = -CPLE_OutOfMemory;
+
+    if (ids != NULL && results != NULL && tags != NULL)
+    {
+        count = poll_completions(ids, results, tags, max_count, wait_nanos);
+        for (jint i = 0; i < count; ++i)
+        {
+            (*env)->DeleteGlobalRef(env, (jobject)tags[i]);
+        }
+        if (count > 0)
+        {
+            (*env)->SetLongArrayRegion(env, _ids, 0, count, (jlong *)ids);
+            (*env)->SetIntArrayRegion(env, _results, 0, count, (jint *)results);
+        }
+    }
+    free(tags);
+    free(results);
+    free(ids);
+
+    return count;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1get_1encoded_1tile(JNIEnv *env, jclass obj,
+                                                                          jlong token,
+                                                                          jint dataset,
+                                                                          jint attempts,
+                                                                          jintArray _src_window,
+                                                                          jintArray _dst_window,
+                                                                          jintArray _band_list,
+                                                                          jint type,
+                                                                          jstring _format,
+                                                                          jobjectArray _creation_options,
+                                                                          jobjectArray _tile,
+                                                                          jlong nanos)
+{
+    jsize option_count = (_creation_options != NULL) ? (*env)->GetArrayLength(env, _creation_options) : 0;
+    if (_format == NULL || _tile == NULL || (*env)->GetArrayLength(env, _tile) < 1 || option_count >= MAX_OPTIONS)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    const char *format = (*env)->GetStringUTFChars(env, _format, NULL);
+    const char *creation_options[MAX_OPTIONS];
+    jint *src_window = (*env)->GetIntArrayElements(env, _src_window, NULL);
+    jint *dst_window = (*env)->GetIntArrayElements(env, _dst_window, NULL);
+    // An empty band list means all bands, like a null one
+    jint *band_list = (_band_list != NULL && (*env)->GetArrayLength(env, _band_list) > 0)
+                          ? (*env)->GetIntArrayElements(env, _band_list, NULL)
+                          : NULL;
+    jint retval = -CPLE_IllegalArg;
+    read_options_t options;
+
+    for (jsize i = 0; i < option_count; ++i)
+    {
+        jstring option = (*env)->GetObjectArrayElement(env, _creation_options, i);
+        creation_options[i] = (*env)->GetStringUTFChars(env, option, NULL);
+        (*env)->DeleteLocalRef(env, option);
+    }
+    creation_options[option_count] = NULL;
+
+    INIT_READ_OPTIONS(options);
+    if (band_list != NULL)
+    {
+        options.band_count = (*env)->GetArrayLength(env, _band_list);
+        options.band_list = (int *)band_list;
+    }
+
+    if (dst_window[0] > 0 && dst_window[1] > 0)
+    {
+        int64_t size = 0;
+        void *out = NULL;
+
+        // Encode once into a native buffer, then copy only the encoded
+        // bytes into a Java array of exactly the right size
+        retval = get_encoded_tile_buffer(token, dataset, attempts, nanos, copies, (int *)src_window, (int *)dst_window, type,
+                                         format, creation_options, &options, &out, &size);
+        if (retval >= 0 && size > INT32_MAX)
+        {
+            retval = -CPLE_OutOfMemory;
+        }
+        else if (retval >= 0)
+        {
+            jbyteArray tile = (*env)->NewByteArray(env, (jsize)size);
+            if (tile == NULL)
+            {
+                retval = -CPLE_OutOfMemory;
+            }
+            else
+            {
+                (*env)->SetByteArrayRegion(env, tile, 0, (jsize)size, (const jbyte *)out);
+                (*env)->SetObjectArrayElement(env, _tile, 0, tile);
+                (*env)->DeleteLocalRef(env, tile);
+            }
+        }
+        free_encoded_tile(out);
+    }
+
+    for (jsize i = 0; i < option_count; ++i)
+    {
+        jstring option = (*env)->GetObjectArrayElement(env, _creation_options, i);
+        (*env)->ReleaseStringUTFChars(env, option, creation_options[i]);
+        (*env)->DeleteLocalRef(env, option);
+    }
+    if (band_list != NULL)
+    {
+        (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    }
+    (*env)->ReleaseIntArrayElements(env, _dst_window, dst_window, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _src_window, src_window, JNI_ABORT);
+    (*env)->ReleaseStringUTFChars(env, _format, format);
+
+    return retval;
+}
+
+JNIEXPORT jint JNICALL Java_com_azavea_gdal_GDALWarp__1warp_1into(JNIEnv *env, jclass obj,
+                                                                  jlong token,
+                                                                  jint attempts,
+                                                                  jstring _dst_srs,
+                                                                  jdoubleArray _dst_transform,
+                                                                  jintArray _dst_size,
+                                                                  jintArray _band_list,
+                                                                  jint resample,
+                                                                  jint type,
+                                                                  jbyteArray _data,
+                                                                  jlong nanos)
+{
+    if (_dst_srs == NULL || _band_list == NULL)
+    {
+        return -CPLE_IllegalArg;
+    }
+
+    const char *dst_srs = (*env)->GetStringUTFChars(env, _dst_srs, NULL);
+    jdouble *dst_transform = (*env)->GetDoubleArrayElements(env, _dst_transform, NULL);
+    jint *dst_size = (*env)->GetIntArrayElements(env, _dst_size, NULL);
+    jint *band_list = (*env)->GetIntArrayElements(env, _band_list, NULL);
+    jsize band_count = (*env)->GetArrayLength(env, _band_list);
+    jsize length = (*env)->GetArrayLength(env, _data);
+    jlong required = (jlong)dst_size[0] * dst_size[1] * band_count * GDALGetDataTypeSizeBytes(type);
+    jint retval = -CPLE_IllegalArg;
+
+    // An empty band list would mean "all bands", which the array is not sized for
+    if (dst_size[0] > 0 && dst_size[1] > 0 && band_count > 0 && required <= length)
+    {
+        read_options_t options;
+        jbyte *data = NULL;
+
+        INIT_READ_OPTIONS(options);
+        options.band_count = band_count;
+        options.band_list = (int *)band_list;
+
+        if (gc_lock)
+        {
+            data = (*env)->GetPrimitiveArrayCritical(env, _data, NULL);
+        }
+        else
+        {
+            data = (*env)->GetByteArrayElements(env, _data, NULL);
+        }
+        retval = warp_into(token, attempts, nanos, copies, dst_srs, dst_transform, (int *)dst_size, resample, type, data, &options);
+        if (retval > 0)
+        {
+            swap_bytes(type, data, (jsize)required);
+        }
+        if (gc_lock)
+        {
+            (*env)->ReleasePrimitiveArrayCritical(env, _data, data, 0);
+        }
+        else
+        {
+            (*env)->ReleaseByteArrayElements(env, _data, data, 0);
+        }
+    }
+    (*env)->ReleaseIntArrayElements(env, _band_list, band_list, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, _dst_size, dst_size, JNI_ABORT);
+    (*env)->ReleaseDoubleArrayElements(env, _dst_transform, dst_transform, JNI_ABORT);
+    (*env)->ReleaseStringUTFChars(env, _dst_srs, dst_srs);
+
+    return retval;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __COMPLETION_QUEUE_HPP__
+#define __COMPLETION_QUEUE_HPP__
+
+#include <cstdint>
+#include <ctime>
+#include <deque>
+
+#include <pthread.h>
+
+/*
+ * A queue of the results of asynchronous requests.  Worker threads
+ * push completions; the application polls for them (possibly
+ * waiting for the first one to arrive).  Once the queue is closed,
+ * polls still take the completions that remain, then report that the
+ * queue is closed instead of waiting.
+ */
+class completion_queue
+{
+public:
+    struct completion_t
+    {
+        int64_t id;
+        int result;
+        void *tag;
+    };
+
+    completion_queue()
+        : m_completions(),
+          m_lock(PTHREAD_MUTEX_INITIALIZER),
+          m_cond(PTHREAD_COND_INITIALIZER),
+          m_closed(false)
+    {
+    }
+
+    completion_queue(const completion_queue &rhs) = delete;
+    completion_queue &operator=(const completion_queue &rhs) = delete;
+
+    ~completion_queue()
+    {
+        pthread_cond_destroy(&m_cond);
+        pthread_mutex_destroy(&m_lock);
+    }
+
+    /*
+     * Record the completion of a request.
+     *
+     * @param id The id of the request
+     * @param result The return value of the request
+     * @param tag The opaque value given when the request was submitted
+     */
+    void push(int64_t id, int result, void *tag)
+    {
+        pthread_mutex_lock(&m_lock);
+        m_completions.push_back(completion_t{id, result, tag});
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    /*
+     * Close (or, if closed is false, reopen) the queue.  Closing wakes
+     * every waiting poll.
+     *
+     * @param closed Whether the queue is closed
+     */
+    void set_closed(bool closed)
+    {
+        pthread_mutex_lock(&m_lock);
+        m_closed = closed;
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    /*
+     * Take up to max_count completions, oldest first.
+     *
+     * @param completions The return-location of the completions
+     * @param max_count The maximum number of completions to take
+     * @param wait_nanos How long to wait (in nanoseconds) for a
+     *                   completion if there is none yet (zero to
+     *                   return immediately)
+     * @return The number of completions taken, or -1 if the queue is
+     *         closed and empty
+     */
+    int poll(completion_t *completions, int max_count, uint64_t wait_nanos)
+    {
+        if (max_count <= 0)
+        {
+            return 0;
+        }
+
+        pthread_mutex_lock(&m_lock);
+        if (m_completions.empty() && wait_nanos > 0 && !m_closed)
+        {
+            timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            uint64_t nanos = static_cast<uint64_t>(until.tv_nsec) + wait_nanos;
+            until.tv_sec += static_cast<time_t>(nanos / 1000000000);
+            until.tv_nsec = static_cast<long>(nanos % 1000000000);
+            while (m_completions.empty() && !m_closed)
+            {
+                if (pthread_cond_timedwait(&m_cond, &m_lock, &until) != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (m_completions.empty() && m_closed)
+        {
+            pthread_mutex_unlock(&m_lock);
+            return -1;
+        }
+
+        int count = 0;
+        while (count < max_count && !m_completions.empty())
+        {
+            completions[count++] = m_completions.front();
+            m_completions.pop_front();
+        }
+        pthread_mutex_unlock(&m_lock);
+
+        return count;
+    }
+
+    /*
+     * The number of completions that have not yet been taken.
+     */
+    size_t size()
+    {
+        pthread_mutex_lock(&m_lock);
+        size_t retval = m_completions.size();
+        pthread_mutex_unlock(&m_lock);
+        return retval;
+    }
+
+private:
+    std::deque<completion_t> m_completions;
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_cond;
+    bool m_closed;
+};
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DATASET_INFO_H__
+#define __DATASET_INFO_H__
+
+#include <stdint.h>
+
+/*
+ * The buffer filled by get_info begins with one info_header_t.
+ * That is followed by band_count records, each of which is an
+ * info_band_t followed by overview_count (width, height) pairs of
+ * int32_t.  The records are followed by the NUL-terminated WKT of
+ * the CRS.  All values are in native byte order and every record
+ * begins on an eight-byte boundary.
+ */
+typedef struct
+{
+    int32_t size;           /* Total number of bytes required */
+    int32_t width;
+    int32_t height;
+    int32_t band_count;
+    int32_t crs_wkt_length; /* Not counting the terminating NUL */
+    int32_t reserved;
+    double transform[6];
+} info_header_t;
+
+typedef struct
+{
+    int32_t data_type;
+    int32_t color_interp;
+    int32_t block_width;
+    int32_t block_height;
+    int32_t has_nodata;
+    int32_t has_offset;
+    int32_t has_scale;
+    int32_t overview_count;
+    double nodata;
+    double offset;
+    double scale;
+} info_band_t;
+
+#endif
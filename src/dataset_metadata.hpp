@@ -0,0 +1,252 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DATASET_METADATA_HPP__
+#define __DATASET_METADATA_HPP__
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gdal.h>
+
+#include "dataset_info.h"
+
+/*
+ * The immutable properties of one band of a GDAL dataset.
+ */
+struct band_metadata
+{
+    GDALDataType data_type;
+    int color_interp;
+    int block_width;
+    int block_height;
+    double nodata;
+    int has_nodata;
+    double offset;
+    int has_offset;
+    double scale;
+    int has_scale;
+    std::vector<std::pair<int, int>> overviews;
+};
+
+/*
+ * A snapshot of those properties of a GDAL dataset that cannot change
+ * after it has been opened read-only (dimensions, transform, CRS, and
+ * per-band types, NODATA values, scales, offsets, block sizes, and
+ * overview sizes).  The snapshot is taken once, while the owning
+ * locked_dataset holds its lock, and can thereafter be read from any
+ * number of threads without synchronization.
+ */
+class dataset_metadata
+{
+public:
+    dataset_metadata()
+        : m_width(0),
+          m_height(0),
+          m_transform{0, 1, 0, 0, 0, 1},
+          m_has_transform(false),
+          m_crs_wkt(),
+          m_bands(),
+          m_valid(false)
+    {
+    }
+
+    /*
+     * Constructor.  The caller must have exclusive access to the
+     * dataset for the duration of this call.
+     *
+     * @param ds The dataset to take a snapshot of
+     */
+    explicit dataset_metadata(GDALDatasetH ds)
+        : dataset_metadata()
+    {
+        if (ds == nullptr)
+        {
+            return;
+        }
+
+        m_width = GDALGetRasterXSize(ds);
+        m_height = GDALGetRasterYSize(ds);
+        m_has_transform = (GDALGetGeoTransform(ds, m_transform) == CE_None);
+        auto wkt = GDALGetProjectionRef(ds);
+        m_crs_wkt = std::string(wkt != nullptr ? wkt : "");
+
+        int band_count = GDALGetRasterCount(ds);
+        m_bands.reserve(band_count);
+        for (int i = 1; i <= band_count; ++i)
+        {
+            GDALRasterBandH band = GDALGetRasterBand(ds, i);
+            band_metadata bm;
+
+            bm.data_type = GDALGetRasterDataType(band);
+            bm.color_interp = GDALGetRasterColorInterpretation(band);
+            GDALGetBlockSize(band, &bm.block_width, &bm.block_height);
+            bm.nodata = GDALGetRasterNoDataValue(band, &bm.has_nodata);
+            bm.offset = GDALGetRasterOffset(band, &bm.has_offset);
+            bm.scale = GDALGetRasterScale(band, &bm.has_scale);
+
+            int overview_count = GDALGetOverviewCount(band);
+            bm.overviews.reserve(overview_count);
+            for (int j = 0; j < overview_count; ++j)
+            {
+                GDALRasterBandH overview = GDALGetOverview(band, j);
+                bm.overviews.emplace_back(GDALGetRasterBandXSize(overview),
+                                          GDALGetRasterBandYSize(overview));
+            }
+
+            m_bands.push_back(std::move(bm));
+        }
+
+        m_valid = true;
+    }
+
+    /*
+     * Was this snapshot taken from a real dataset?
+     */
+    bool valid() const
+    {
+        return m_valid;
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
+    }
+
+    const double *transform() const
+    {
+        return m_transform;
+    }
+
+    /*
+     * Does the dataset have a geotransform of its own (rather than,
+     * say, GCPs or RPCs)?
+     */
+    bool has_transform() const
+    {
+        return m_has_transform;
+    }
+
+    const std::string &crs_wkt() const
+    {
+        return m_crs_wkt;
+    }
+
+    int band_count() const
+    {
+        return static_cast<int>(m_bands.size());
+    }
+
+    /*
+     * Get the properties of a band.
+     *
+     * @param band_number The (one-based) band number
+     * @return A pointer to the band properties or nullptr if there is
+     *         no such band
+     */
+    const band_metadata *band(int band_number) const
+    {
+        if (band_number < 1 || band_number > band_count())
+        {
+            return nullptr;
+        }
+        return &m_bands[band_number - 1];
+    }
+
+    /*
+     * Write the snapshot into a buffer using the layout described in
+     * dataset_info.h (see info_header_t).  If the buffer is too small, only
+     * the first max_size bytes are written; the size field of the
+     * header always gives the number of bytes that the complete
+     * record requires.
+     *
+     * @param buffer The destination buffer
+     * @param max_size The size of the destination buffer in bytes
+     * @return The number of bytes that the complete record requires
+     */
+    int serialize(void *buffer, int max_size) const
+    {
+        size_t size = sizeof(info_header_t);
+        for (const auto &bm : m_bands)
+        {
+            size += sizeof(info_band_t) + align8(bm.overviews.size() * 2 * sizeof(int32_t));
+        }
+        size += align8(m_crs_wkt.size() + 1);
+
+        auto bytes = std::vector<char>(size, 0);
+        auto header = reinterpret_cast<info_header_t *>(bytes.data());
+        header->size = static_cast<int32_t>(size);
+        header->width = m_width;
+        header->height = m_height;
+        header->band_count = band_count();
+        header->crs_wkt_length = static_cast<int32_t>(m_crs_wkt.size());
+        std::copy(m_transform, m_transform + 6, header->transform);
+
+        size_t offset = sizeof(info_header_t);
+        for (const auto &bm : m_bands)
+        {
+            auto record = reinterpret_cast<info_band_t *>(bytes.data() + offset);
+            record->data_type = bm.data_type;
+            record->color_interp = bm.color_interp;
+            record->block_width = bm.block_width;
+            record->block_height = bm.block_height;
+            record->has_nodata = bm.has_nodata;
+            record->has_offset = bm.has_offset;
+            record->has_scale = bm.has_scale;
+            record->overview_count = static_cast<int32_t>(bm.overviews.size());
+            record->nodata = bm.nodata;
+            record->offset = bm.offset;
+            record->scale = bm.scale;
+            offset += sizeof(info_band_t);
+
+            auto pairs = reinterpret_cast<int32_t *>(bytes.data() + offset);
+            for (const auto &overview : bm.overviews)
+            {
+                *pairs++ = overview.first;
+                *pairs++ = overview.second;
+            }
+            offset += align8(bm.overviews.size() * 2 * sizeof(int32_t));
+        }
+        memcpy(bytes.data() + offset, m_crs_wkt.c_str(), m_crs_wkt.size() + 1);
+
+        memcpy(buffer, bytes.data(), std::min(size, static_cast<size_t>(max_size)));
+        return static_cast<int>(size);
+    }
+
+private:
+    static size_t align8(size_t n)
+    {
+        return (n + 7) & ~static_cast<size_t>(7);
+    }
+
+    int m_width;
+    int m_height;
+    double m_transform[6];
+    bool m_has_transform;
+    std::string m_crs_wkt;
+    std::vector<band_metadata> m_bands;
+    bool m_valid;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DEADLINE_HPP__
+#define __DEADLINE_HPP__
+
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include <cpl_conv.h>
+#include <gdal.h>
+
+/*
+ * The value of a monotonic clock in nanoseconds (always zero where
+ * there is no such clock, which disables deadlines).
+ */
+inline uint64_t get_nanos()
+{
+#if defined(__linux__)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (((uint64_t)ts.tv_sec) * 1000000000) + ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * The deadline (in terms of get_nanos) of the call that the current
+ * thread is serving, or zero for none.
+ */
+inline uint64_t &current_deadline()
+{
+    static thread_local uint64_t deadline = 0;
+    return deadline;
+}
+
+/*
+ * The deadline (in terms of get_nanos) of a call with the given time
+ * budget that starts now, or zero for none.  An earlier deadline of
+ * the current thread wins.
+ */
+inline uint64_t deadline_after(uint64_t budget)
+{
+    uint64_t now = get_nanos();
+    uint64_t deadline = (budget > 0 && now > 0) ? now + budget : 0;
+    uint64_t enclosing = current_deadline();
+    return (enclosing != 0 && (deadline == 0 || enclosing < deadline)) ? enclosing : deadline;
+}
+
+/*
+ * The time budget left before a deadline, to pass as the nanos of the
+ * calls that make up a larger call (possibly on other threads, which
+ * do not share its deadline_scope).  This is zero if there is no
+ * deadline, and at least one once the deadline has passed (callers
+ * should then check deadline_passed instead of making the call).
+ */
+inline uint64_t nanos_until(uint64_t deadline)
+{
+    if (deadline == 0)
+    {
+        return 0;
+    }
+    uint64_t now = get_nanos();
+    return (deadline > now) ? deadline - now : 1;
+}
+
+/*
+ * Whether the given deadline (zero for none) has passed.
+ */
+inline bool deadline_passed(uint64_t deadline)
+{
+    return deadline != 0 && get_nanos() >= deadline;
+}
+
+/*
+ * A GDALProgressFunc that asks GDAL to abort the operation in
+ * progress once the deadline of the current thread has passed.  GDAL
+ * then fails the operation with CPLE_UserInterrupt.
+ */
+inline int CPL_STDCALL deadline_progress(double complete, const char *message, void *arg)
+{
+    uint64_t deadline = current_deadline();
+    return (deadline == 0 || get_nanos() < deadline) ? TRUE : FALSE;
+}
+
+/*
+ * Set the deadline of the current thread for the lifetime of this
+ * object (an enclosing earlier deadline wins).  GDAL_HTTP_TIMEOUT is
+ * also capped, for this thread only, at the time remaining, so a
+ * stalled remote read gives up at about the same time instead of
+ * holding the thread until the network times out.
+ */
+class deadline_scope
+{
+public:
+    explicit deadline_scope(uint64_t deadline)
+        : m_previous(current_deadline()),
+          m_timeout_set(false),
+          m_had_timeout(false),
+          m_timeout()
+    {
+        if (deadline == 0 || (m_previous != 0 && m_previous <= deadline))
+        {
+            return;
+        }
+        current_deadline() = deadline;
+
+        uint64_t now = get_nanos();
+        long seconds = (deadline > now) ? static_cast<long>((deadline - now + 999999999) / 1000000000) : 1;
+        const char *timeout = CPLGetConfigOption("GDAL_HTTP_TIMEOUT", nullptr);
+        if (timeout != nullptr && atol(timeout) > 0 && atol(timeout) <= seconds)
+        {
+            return;
+        }
+        const char *local = CPLGetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", nullptr);
+        m_had_timeout = (local != nullptr);
+        m_timeout = (local != nullptr) ? std::string(local) : std::string();
+        m_timeout_set = true;
+        CPLSetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", std::to_string(seconds).c_str());
+    }
+
+    deadline_scope(const deadline_scope &rhs) = delete;
+    deadline_scope &operator=(const deadline_scope &rhs) = delete;
+
+    ~deadline_scope()
+    {
+        if (m_timeout_set)
+        {
+            CPLSetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", m_had_timeout ? m_timeout.c_str() : nullptr);
+        }
+        current_deadline() = m_previous;
+    }
+
+private:
+    uint64_t m_previous;
+    bool m_timeout_set;
+    bool m_had_timeout;
+    std::string m_timeout;
+};
+
+#endif
@@ -62,7 +62,7 @@ int main(int argc, char **argv)
 
     for (int i = 0; i < (1 << 18); ++i)
     {
-      assert(noop(token, locked_dataset::SOURCE, 0, 1) > 0);
+      assert(noop(token, locked_dataset::SOURCE, 0, 0, 1) > 0);
     }
   }
 
@@ -71,7 +71,7 @@ int main(int argc, char **argv)
 
     for (int i = 0; i < (1 << 18); ++i)
     {
-      assert(get_metadata_domain_list(token, 0, 10, 1, 0, &domain_list) > 0);
+      assert(get_metadata_domain_list(token, 0, 10, 0, 1, 0, &domain_list) > 0);
       CSLDestroy(domain_list);
     }
   }
@@ -105,10 +105,10 @@ void *reader(void *argv1)
 
         token = get_token(uri, options);
 
-        NOTE(get_crs_wkt(token, token % 2, ATTEMPTS, COPIES, buf, BUFFERSIZE));
-        NOTE(get_crs_proj4(token, token % 2, ATTEMPTS, COPIES, buf, BUFFERSIZE));
-        NOTE(get_band_nodata(token, token % 2, ATTEMPTS, COPIES, 1, transform, &scratch1));
-        NOTE(get_width_height(token, token % 2, ATTEMPTS, COPIES, &scratch1, &scratch2));
+        NOTE(get_crs_wkt(token, token % 2, ATTEMPTS, 0, COPIES, buf, BUFFERSIZE));
+        NOTE(get_crs_proj4(token, token % 2, ATTEMPTS, 0, COPIES, buf, BUFFERSIZE));
+        NOTE(get_band_nodata(token, token % 2, ATTEMPTS, 0, COPIES, 1, transform, &scratch1));
+        NOTE(get_width_height(token, token % 2, ATTEMPTS, 0, COPIES, &scratch1, &scratch2));
         NOTE(get_data(token, token % 2, ATTEMPTS, 0, COPIES, src_window, dst_window, 1, 1 /* GDT_Byte */, buf));
     }
 
@@ -92,10 +92,10 @@ void *reader(void *argv1)
             token = get_token(static_cast<const char *>(argv1), options);
         }
 
-        get_crs_wkt(token, token % 2, ATTEMPTS, COPIES, buf, BUFFERSIZE);
-        get_crs_proj4(token, token % 2, ATTEMPTS, COPIES, buf, BUFFERSIZE);
-        get_band_nodata(token, token % 2, ATTEMPTS, COPIES, 1, transform, &scratch1);
-        get_width_height(token, token % 2, ATTEMPTS, COPIES, &scratch1, &scratch2);
+        get_crs_wkt(token, token % 2, ATTEMPTS, 0, COPIES, buf, BUFFERSIZE);
+        get_crs_proj4(token, token % 2, ATTEMPTS, 0, COPIES, buf, BUFFERSIZE);
+        get_band_nodata(token, token % 2, ATTEMPTS, 0, COPIES, 1, transform, &scratch1);
+        get_width_height(token, token % 2, ATTEMPTS, 0, COPIES, &scratch1, &scratch2);
         get_data(token, token % 2, ATTEMPTS, 0, COPIES, src_window, dst_window, 1, 1 /* GDT_Byte */, buf);
     }
 
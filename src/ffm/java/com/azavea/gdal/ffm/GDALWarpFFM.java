@@ -0,0 +1,434 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.azavea.gdal.ffm;
+
+import static java.lang.foreign.ValueLayout.ADDRESS;
+import static java.lang.foreign.ValueLayout.JAVA_DOUBLE;
+import static java.lang.foreign.ValueLayout.JAVA_INT;
+import static java.lang.foreign.ValueLayout.JAVA_LONG;
+
+import java.lang.foreign.Arena;
+import java.lang.foreign.FunctionDescriptor;
+import java.lang.foreign.Linker;
+import java.lang.foreign.MemoryLayout;
+import java.lang.foreign.MemoryLayout.PathElement;
+import java.lang.foreign.MemorySegment;
+import java.lang.foreign.StructLayout;
+import java.lang.foreign.SymbolLookup;
+import java.lang.invoke.MethodHandle;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+import com.azavea.gdal.GDALWarp;
+
+/**
+ * An optional binding of the C API in bindings.h through the Foreign Function
+ * and Memory API (JDK 22 or later), next to the JNI binding in GDALWarp. It
+ * uses the same native library, which is loaded and initialized by GDALWarp,
+ * so the two can be mixed freely (tokens are shared).
+ *
+ * Every call that goes through the dataset cache (which may open a remote
+ * file, wait for a dataset lock, or retry) is a normal downcall, since a
+ * critical one would hold up garbage collection for as long as it runs; only
+ * the pure get_read_options_layout is linked as critical. Small results are
+ * returned through per-thread native scratch space and copied into the
+ * caller's arrays, while calls that read pixels take native MemorySegments
+ * (for example from an Arena) and write them in native byte order, without
+ * any glue copies.
+ *
+ * Applications must be run with --enable-native-access for the module (or
+ * ALL-UNNAMED) that contains this class.
+ */
+public final class GDALWarpFFM {
+        private static final int COPIES = -4; // as in the JNI binding
+        private static final int CPLE_IllegalArg = 5;
+        private static final int GDT_UInt64 = 12; // not in GDALWarp, whose GDT_TypeCount predates them
+        private static final int GDT_Int64 = 13;
+
+        private static final Linker LINKER = Linker.nativeLinker();
+        private static final SymbolLookup LOOKUP;
+
+        static {
+                // Loading GDALWarp loads (and initializes) the native library
+                GDALWarp.get_native_order();
+                LOOKUP = SymbolLookup.loaderLookup();
+        }
+
+        /* read_options_t (see read_options.h) */
+        private static final StructLayout READ_OPTIONS = MemoryLayout.structLayout( /* */
+                        JAVA_INT.withName("band_count"), MemoryLayout.paddingLayout(4), /* */
+                        ADDRESS.withName("band_list"), /* */
+                        JAVA_INT.withName("interleave"), MemoryLayout.paddingLayout(4), /* */
+                        JAVA_LONG.withName("pixel_space"), /* */
+                        JAVA_LONG.withName("line_space"), /* */
+                        JAVA_LONG.withName("band_space"), /* */
+                        JAVA_INT.withName("overview"), /* */
+                        JAVA_INT.withName("resampling"), /* */
+                        JAVA_INT.withName("has_fractional_window"), MemoryLayout.paddingLayout(4), /* */
+                        MemoryLayout.sequenceLayout(4, JAVA_DOUBLE).withName("fractional_window"), /* */
+                        ADDRESS.withName("mask"), /* */
+                        JAVA_INT.withName("mask_packed"), MemoryLayout.paddingLayout(4));
+
+        private static final long BAND_COUNT = offset("band_count");
+        private static final long BAND_LIST = offset("band_list");
+        private static final long INTERLEAVE = offset("interleave");
+        private static final long OVERVIEW = offset("overview");
+
+        /* Per-thread native scratch space: windows, then options, then bands */
+        private static final int SCRATCH_OPTIONS = 32;
+        private static final int SCRATCH_BANDS = 256;
+        private static final int SCRATCH_SIZE = 4096;
+        private static final int MAX_SCRATCH_BANDS = (SCRATCH_SIZE - SCRATCH_BANDS) / 4;
+        private static final ThreadLocal<MemorySegment> scratch = ThreadLocal
+                        .withInitial(() -> Arena.ofAuto().allocate(SCRATCH_SIZE, 8));
+
+        private static final MethodHandle NOOP = handle("noop", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT);
+        private static final MethodHandle GET_TOKEN = handle("get_token", false, /* */
+                        JAVA_LONG, ADDRESS, ADDRESS);
+        private static final MethodHandle GET_WIDTH_HEIGHT = handle("get_width_height", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, ADDRESS, ADDRESS);
+        private static final MethodHandle GET_BAND_COUNT = handle("get_band_count", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, ADDRESS);
+        private static final MethodHandle GET_TRANSFORM = handle("get_transform", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, ADDRESS);
+        private static final MethodHandle GET_BAND_NODATA = handle("get_band_nodata", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, ADDRESS, ADDRESS);
+        private static final MethodHandle GET_INFO = handle("get_info", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, ADDRESS, JAVA_INT);
+        private static final MethodHandle GET_DATA = handle("get_data", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, /* */
+                        ADDRESS, ADDRESS, JAVA_INT, JAVA_INT, ADDRESS);
+        private static final MethodHandle GET_DATA_EX = handle("get_data_ex", false, /* */
+                        JAVA_INT, JAVA_LONG, JAVA_INT, JAVA_INT, JAVA_LONG, JAVA_INT, /* */
+                        ADDRESS, ADDRESS, JAVA_INT, ADDRESS, ADDRESS);
+        private static final MethodHandle GET_READ_OPTIONS_LAYOUT = handle("get_read_options_layout", true, /* */
+                        JAVA_INT, ADDRESS, JAVA_INT);
+
+        static {
+                check_layout();
+        }
+
+        private GDALWarpFFM() {
+        }
+
+        private static long offset(String name) {
+                return READ_OPTIONS.byteOffset(PathElement.groupElement(name));
+        }
+
+        /**
+         * Check READ_OPTIONS against the read_options_t that the native library was
+         * compiled with, so that a change to read_options.h cannot silently break
+         * this binding.
+         */
+        private static void check_layout() {
+                String[] fields = { "band_count", "band_list", "interleave", "pixel_space", "line_space",
+                                "band_space", "overview", "resampling", "has_fractional_window", "fractional_window",
+                                "mask", "mask_packed" };
+                long[] layout = new long[fields.length + 1];
+                int count;
+                try {
+                        count = (int) GET_READ_OPTIONS_LAYOUT.invokeExact(MemorySegment.ofArray(layout), layout.length);
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+                boolean matches = (count == layout.length) && (layout[0] == READ_OPTIONS.byteSize());
+                for (int i = 0; matches && i < fields.length; ++i) {
+                        matches = (layout[i + 1] == offset(fields[i]));
+                }
+                if (!matches) {
+                        throw new LinkageError("READ_OPTIONS does not match read_options_t in the native library");
+                }
+        }
+
+        private static MethodHandle handle(String name, boolean critical, MemoryLayout result,
+                        MemoryLayout... arguments) {
+                MemorySegment symbol = LOOKUP.find(name).orElseThrow(() -> new UnsatisfiedLinkError(name));
+                FunctionDescriptor descriptor = FunctionDescriptor.of(result, arguments);
+                if (critical) {
+                        return LINKER.downcallHandle(symbol, descriptor, Linker.Option.critical(true));
+                } else {
+                        return LINKER.downcallHandle(symbol, descriptor);
+                }
+        }
+
+        private static IllegalStateException rethrow(Throwable t) {
+                if (t instanceof RuntimeException) {
+                        throw (RuntimeException) t;
+                } else if (t instanceof Error) {
+                        throw (Error) t;
+                }
+                return new IllegalStateException(t);
+        }
+
+        /**
+         * @see GDALWarp#get_token
+         */
+        public static long get_token(String uri, String[] options) {
+                try (Arena arena = Arena.ofConfined()) {
+                        MemorySegment _options = arena.allocate(ADDRESS, options.length + 1);
+                        for (int i = 0; i < options.length; ++i) {
+                                _options.setAtIndex(ADDRESS, i, arena.allocateFrom(options[i]));
+                        }
+                        _options.setAtIndex(ADDRESS, options.length, MemorySegment.NULL);
+                        return (long) GET_TOKEN.invokeExact(arena.allocateFrom(uri), _options);
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * @see GDALWarp#noop
+         */
+        public static int noop(long token, int dataset, int attempts) {
+                try {
+                        return (int) NOOP.invokeExact(token, dataset, attempts, 0L, COPIES);
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * @see GDALWarp#get_width_height
+         */
+        public static int get_width_height(long token, int dataset, int attempts, int[] width_height) {
+                MemorySegment _width_height = scratch.get();
+                try {
+                        int retval = (int) GET_WIDTH_HEIGHT.invokeExact(token, dataset, attempts, 0L, COPIES,
+                                        _width_height, _width_height.asSlice(4));
+                        if (retval > 0) {
+                                MemorySegment.copy(_width_height, JAVA_INT, 0, width_height, 0, 2);
+                        }
+                        return retval;
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * @see GDALWarp#get_band_count
+         */
+        public static int get_band_count(long token, int dataset, int attempts, int[] band_count) {
+                MemorySegment _band_count = scratch.get();
+                try {
+                        int retval = (int) GET_BAND_COUNT.invokeExact(token, dataset, attempts, 0L, COPIES,
+                                        _band_count);
+                        if (retval > 0) {
+                                band_count[0] = _band_count.get(JAVA_INT, 0);
+                        }
+                        return retval;
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * @see GDALWarp#get_transform
+         */
+        public static int get_transform(long token, int dataset, int attempts, double[] transform) {
+                MemorySegment _transform = scratch.get();
+                try {
+                        int retval = (int) GET_TRANSFORM.invokeExact(token, dataset, attempts, 0L, COPIES,
+                                        _transform);
+                        if (retval > 0) {
+                                MemorySegment.copy(_transform, JAVA_DOUBLE, 0, transform, 0, 6);
+                        }
+                        return retval;
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * @see GDALWarp#get_band_nodata
+         */
+        public static int get_band_nodata(long token, int dataset, int attempts, int band_number, double[] nodata,
+                        int[] success) {
+                MemorySegment _nodata = scratch.get();
+                try {
+                        int retval = (int) GET_BAND_NODATA.invokeExact(token, dataset, attempts, 0L, COPIES, band_number,
+                                        _nodata, _nodata.asSlice(8));
+                        if (retval > 0) {
+                                nodata[0] = _nodata.get(JAVA_DOUBLE, 0);
+                                success[0] = _nodata.get(JAVA_INT, 8);
+                        }
+                        return retval;
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * Get all of the immutable properties of a dataset in one call (see
+         * GDALWarp#get_info for the layout of the record).
+         *
+         * @param token    A token associated with some uri, options pair
+         * @param dataset  0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                 GDALWarp::WARPED) for the warped dataset
+         * @param attempts The number of attempts to make before giving up
+         * @param info     The return-location of the record (in native byte order)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_info(long token, int dataset, int attempts, ByteBuffer[] info) {
+                int size = 1 << 16;
+                try {
+                        while (true) {
+                                MemorySegment segment = Arena.ofAuto().allocate(size, 8);
+                                int retval = (int) GET_INFO.invokeExact(token, dataset, attempts, 0L, COPIES, segment,
+                                                size);
+                                if (retval < 0) {
+                                        return retval;
+                                }
+                                int required = segment.get(JAVA_INT, GDALWarp.INFO_SIZE);
+                                if (required <= size) {
+                                        info[0] = segment.asSlice(0, required).asByteBuffer()
+                                                        .order(ByteOrder.nativeOrder());
+                                        return retval;
+                                }
+                                size = required;
+                        }
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * Get pixel data from one band into native memory, in native byte order.
+         *
+         * @param token       A token associated with some uri, options pair
+         * @param dataset     0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                    GDALWarp::WARPED) for the warped dataset
+         * @param attempts    The number of attempts to make before giving up
+         * @param src_window  The source window (as in GDALWarp#get_data)
+         * @param dst_window  The destination size (as in GDALWarp#get_data)
+         * @param band_number The band of interest
+         * @param type        The desired type of returned pixels (the argument is of
+         *                    integral type GDALDataType)
+         * @param data        The (native) return-location of the read data
+         * @param nanos       The time budget of the call in nanoseconds (zero to limit
+         *                    only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data(long token, int dataset, int attempts, int[] src_window, int[] dst_window,
+                        int band_number, int type, MemorySegment data, long nanos) {
+                int size = size_of(type);
+                if (size == 0 || !data.isNative() || data.byteSize() < (long) dst_window[0] * dst_window[1] * size) {
+                        return -CPLE_IllegalArg;
+                }
+                MemorySegment windows = windows(src_window, dst_window);
+                try {
+                        return (int) GET_DATA.invokeExact(token, dataset, attempts, nanos, COPIES, windows,
+                                        windows.asSlice(16), band_number, type, data);
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                }
+        }
+
+        /**
+         * Get pixel data from several bands into native memory, in native byte
+         * order, with the given interleaving.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in GDALWarp#get_data)
+         * @param dst_window The destination size (as in GDALWarp#get_data)
+         * @param band_list  The bands of interest (at least one)
+         * @param interleave One of the GDALWarp.INTERLEAVE_* layouts
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The (native) return-location of the read data
+         * @param nanos      The time budget of the call in nanoseconds (zero to limit
+         *                   only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         * @throws IllegalArgumentException If band_list is empty
+         */
+        public static int get_data(long token, int dataset, int attempts, int[] src_window, int[] dst_window,
+                        int[] band_list, int interleave, int type, MemorySegment data, long nanos) {
+                if (band_list.length == 0) {
+                        throw new IllegalArgumentException("band_list must name at least one band");
+                }
+                int size = size_of(type);
+                long required = (long) dst_window[0] * dst_window[1] * band_list.length * size;
+                if (size == 0 || !data.isNative() || data.byteSize() < required) {
+                        return -CPLE_IllegalArg;
+                }
+                MemorySegment windows = windows(src_window, dst_window);
+                MemorySegment options = windows.asSlice(SCRATCH_OPTIONS, READ_OPTIONS.byteSize());
+                Arena arena = (band_list.length > MAX_SCRATCH_BANDS) ? Arena.ofConfined() : null;
+                MemorySegment bands = (arena != null) ? arena.allocate(JAVA_INT, band_list.length)
+                                : windows.asSlice(SCRATCH_BANDS, 4L * band_list.length);
+
+                MemorySegment.copy(band_list, 0, bands, JAVA_INT, 0, band_list.length);
+                options.fill((byte) 0);
+                options.set(JAVA_INT, BAND_COUNT, band_list.length);
+                options.set(ADDRESS, BAND_LIST, bands);
+                options.set(JAVA_INT, INTERLEAVE, interleave);
+                options.set(JAVA_INT, OVERVIEW, -1);
+                try {
+                        return (int) GET_DATA_EX.invokeExact(token, dataset, attempts, nanos, COPIES, windows,
+                                        windows.asSlice(16), type, data, options);
+                } catch (Throwable t) {
+                        throw rethrow(t);
+                } finally {
+                        if (arena != null) {
+                                arena.close();
+                        }
+                }
+        }
+
+        private static MemorySegment windows(int[] src_window, int[] dst_window) {
+                MemorySegment windows = scratch.get();
+                MemorySegment.copy(src_window, 0, windows, JAVA_INT, 0, 4);
+                MemorySegment.copy(dst_window, 0, windows, JAVA_INT, 16, 2);
+                return windows;
+        }
+
+        /**
+         * The size in bytes of a pixel of the given type, as GDALGetDataTypeSizeBytes
+         * gives it, or zero for types of unknown size (whose reads are refused).
+         */
+        private static int size_of(int type) {
+                switch (type) {
+                case GDALWarp.GDT_Byte:
+                case GDALWarp.GDT_Int8:
+                        return 1;
+                case GDALWarp.GDT_UInt16:
+                case GDALWarp.GDT_Int16:
+                        return 2;
+                case GDALWarp.GDT_UInt32:
+                case GDALWarp.GDT_Int32:
+                case GDALWarp.GDT_Float32:
+                case GDALWarp.GDT_CInt16:
+                        return 4;
+                case GDALWarp.GDT_Float64:
+                case GDT_UInt64:
+                case GDT_Int64:
+                case GDALWarp.GDT_CInt32:
+                case GDALWarp.GDT_CFloat32:
+                        return 8;
+                case GDALWarp.GDT_CFloat64:
+                        return 16;
+                default:
+                        return 0;
+                }
+        }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.azavea.gdal.ffm;
+
+import java.lang.foreign.Arena;
+import java.lang.foreign.MemorySegment;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+
+import com.azavea.gdal.GDALWarp;
+
+/**
+ * Per-call overhead of the JNI binding (GDALWarp) against the FFM binding
+ * (GDALWarpFFM), on the same native library, for a call that does no I/O
+ * (noop), a metadata call, and small reads into heap, direct and native
+ * memory.
+ */
+@State(Scope.Thread)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(value = 1, jvmArgsAppend = { "--enable-native-access=ALL-UNNAMED" })
+public class GDALWarpBenchmark {
+
+        @Param({ "../experiments/data/c41078a1.tif" })
+        public String uri;
+
+        @Param({ "16" })
+        public int size;
+
+        private long token;
+        private int[] src_window;
+        private int[] dst_window;
+        private int[] width_height;
+        private byte[] heap;
+        private ByteBuffer direct;
+        private Arena arena;
+        private MemorySegment segment;
+
+        @Setup(Level.Trial)
+        public void setup() {
+                String[] options = { /* */
+                                "-tap", "-tr", "33", "42", /* */
+                                "-r", "bilinear", /* */
+                                "-t_srs", "epsg:3857" /* */
+                };
+                token = GDALWarp.get_token(uri, options);
+                src_window = new int[] { 0, 0, size, size };
+                dst_window = new int[] { size, size };
+                width_height = new int[2];
+                heap = new byte[size * size];
+                direct = ByteBuffer.allocateDirect(size * size).order(ByteOrder.nativeOrder());
+                arena = Arena.ofConfined();
+                segment = arena.allocate(size * size, 64);
+
+                // Open the dataset once, so that only the calls are measured
+                if (GDALWarp.get_data(token, GDALWarp.SOURCE, 1, src_window, dst_window, 1, GDALWarp.GDT_Byte,
+                                heap) < 0) {
+                        throw new IllegalStateException("unable to read " + uri);
+                }
+        }
+
+        @TearDown(Level.Trial)
+        public void teardown() {
+                arena.close();
+        }
+
+        @Benchmark
+        public int jni_noop() {
+                return GDALWarp.noop(token, GDALWarp.SOURCE, 1);
+        }
+
+        @Benchmark
+        public int ffm_noop() {
+                return GDALWarpFFM.noop(token, GDALWarp.SOURCE, 1);
+        }
+
+        @Benchmark
+        public int jni_get_width_height() {
+                return GDALWarp.get_width_height(token, GDALWarp.SOURCE, 1, width_height);
+        }
+
+        @Benchmark
+        public int ffm_get_width_height() {
+                return GDALWarpFFM.get_width_height(token, GDALWarp.SOURCE, 1, width_height);
+        }
+
+        @Benchmark
+        public int jni_get_data() {
+                return GDALWarp.get_data(token, GDALWarp.SOURCE, 1, src_window, dst_window, 1, GDALWarp.GDT_Byte,
+                                heap);
+        }
+
+        @Benchmark
+        public int jni_get_data_direct() {
+                direct.clear();
+                return GDALWarp.get_data(token, GDALWarp.SOURCE, 1, src_window, dst_window, 1, GDALWarp.GDT_Byte,
+                                direct);
+        }
+
+        @Benchmark
+        public int ffm_get_data() {
+                return GDALWarpFFM.get_data(token, GDALWarp.SOURCE, 1, src_window, dst_window, 1, GDALWarp.GDT_Byte,
+                                segment, 0L);
+        }
+}
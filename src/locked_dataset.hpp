@@ -24,20 +24,31 @@ typedef _locale_t locale_t;
 #endif
 
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
+#include <tuple>
+#include <vector>
 
 #include <pthread.h>
 
 #include <gdal.h>
 #include <gdal_utils.h>
+#include <gdal_alg.h>
+#include <gdalwarper.h>
 #include <cpl_conv.h>
+#include <cpl_string.h>
 #include <ogr_srs_api.h>
 
 #include "types.hpp"
 #include "errorcodes.hpp"
+#include "dataset_metadata.hpp"
+#include "read_options.h"
+#include "transformer_cache.hpp"
+#include "deadline.hpp"
 
 typedef std::atomic<int> atomic_int_t;
 
@@ -64,7 +75,20 @@ constexpr int DATASET_LOCKED = std::numeric_limits<int>::lowest();
         }                              \
     }
 #define UNLOCK pthread_mutex_unlock(&m_dataset_lock);
+#define BAND_METADATA(bm)                            \
+    auto bm = m_metadata[dataset].band(band_number); \
+    if (bm == nullptr)                               \
+    {                                                \
+        return -CPLE_IllegalArg;                     \
+    }
 
+/*
+ * A pair of GDAL datasets (the source and the warped VRT) guarded by
+ * a mutex.  Properties that cannot change after the datasets are
+ * opened are captured in a dataset_metadata snapshot at open time;
+ * the accessors for those properties do not take the mutex, so they
+ * never wait behind (or fail because of) pixel reads in progress.
+ */
 class locked_dataset
 {
 public:
@@ -110,6 +134,8 @@ public:
         // just-created local that is not in use anywhere else.
         m_datasets[SOURCE] = std::exchange(rhs.m_datasets[SOURCE], nullptr);
         m_datasets[WARPED] = std::exchange(rhs.m_datasets[WARPED], nullptr);
+        m_metadata[SOURCE] = std::exchange(rhs.m_metadata[SOURCE], dataset_metadata());
+        m_metadata[WARPED] = std::exchange(rhs.m_metadata[WARPED], dataset_metadata());
     }
 
     locked_dataset &operator=(locked_dataset &rhs) = delete;
@@ -128,6 +154,8 @@ public:
 
         m_datasets[SOURCE] = std::exchange(rhs.m_datasets[SOURCE], nullptr);
         m_datasets[WARPED] = std::exchange(rhs.m_datasets[WARPED], nullptr);
+        m_metadata[SOURCE] = std::exchange(rhs.m_metadata[SOURCE], dataset_metadata());
+        m_metadata[WARPED] = std::exchange(rhs.m_metadata[WARPED], dataset_metadata());
         m_uri_options = std::move(rhs.m_uri_options);
 
         // m_dataset_lock known to be locked prior to this call if
@@ -166,14 +194,46 @@ public:
      * @param band_number The band in question
      * @param width The return-location of the block width
      * @param height The return-location of the block height
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
+     */
+    int get_block_size(int dataset, int band_number, int *width, int *height) const
+    {
+        BAND_METADATA(bm)
+        *width = bm->block_width;
+        *height = bm->block_height;
+        SUCCESS
+    }
+
+    /**
+     * Get the block size of an overview of the given band.
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param band_number The band in question
+     * @param overview The overview in question
+     * @param width The return-location of the block width
+     * @param height The return-location of the block height
      * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
      */
-    int get_block_size(int dataset, int band_number, int *width, int *height)
+    int get_overview_block_size(int dataset, int band_number, int overview, int *width, int *height) const
     {
+        BAND_METADATA(bm)
+        if (overview < 0 || overview >= static_cast<int>(bm->overviews.size()))
+        {
+            return -CPLE_IllegalArg;
+        }
+
         TRYLOCK
-        GDALRasterBandH band = GDALGetRasterBand(m_datasets[dataset], band_number);
-        GDALGetBlockSize(band, width, height);
+        auto band = GDALGetOverview(GDALGetRasterBand(m_datasets[dataset], band_number), overview);
+        if (band != nullptr)
+        {
+            GDALGetBlockSize(band, width, height);
+        }
         UNLOCK
+
+        if (band == nullptr)
+        {
+            return -CPLE_IllegalArg;
+        }
         SUCCESS
     }
 
@@ -195,7 +255,7 @@ public:
         TRYLOCK
         GDALRasterBandH bandh = GDALGetRasterBand(m_datasets[dataset], band_number);
         auto retval = GDALGetRasterHistogramEx(bandh, lower, upper, num_buckets,
-                                               hist, include_out_of_range, approx_ok, NULL, NULL);
+                                               hist, include_out_of_range, approx_ok, deadline_progress, NULL);
         UNLOCK
         if (retval == CE_None)
         {
@@ -214,14 +274,13 @@ public:
      * @param band_number The band in question
      * @param offset The return-location of the offset
      * @param success The return-location of the success flag
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_offset(int dataset, int band_number, double *offset, int *success)
+    int get_offset(int dataset, int band_number, double *offset, int *success) const
     {
-        TRYLOCK
-        GDALRasterBandH bandh = GDALGetRasterBand(m_datasets[dataset], band_number);
-        *offset = GDALGetRasterOffset(bandh, success);
-        UNLOCK
+        BAND_METADATA(bm)
+        *offset = bm->offset;
+        *success = bm->has_offset;
         SUCCESS
     }
 
@@ -232,14 +291,13 @@ public:
      * @param band_number The band in question
      * @param scale The return-location of the scale
      * @param success The return-location of the success flag
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_scale(int dataset, int band_number, double *scale, int *success)
+    int get_scale(int dataset, int band_number, double *scale, int *success) const
     {
-        TRYLOCK
-        GDALRasterBandH bandh = GDALGetRasterBand(m_datasets[dataset], band_number);
-        *scale = GDALGetRasterScale(bandh, success);
-        UNLOCK
+        BAND_METADATA(bm)
+        *scale = bm->scale;
+        *success = bm->has_scale;
         SUCCESS
     }
 
@@ -250,14 +308,12 @@ public:
      * @param band_number The band in question
      * @param color_interp The return-slot for the integer-coded color
      *                     interpretation
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_color_interpretation(int dataset, int band_number, int *color_interp)
+    int get_color_interpretation(int dataset, int band_number, int *color_interp) const
     {
-        TRYLOCK
-        GDALRasterBandH bandh = GDALGetRasterBand(m_datasets[dataset], band_number);
-        *color_interp = GDALGetRasterColorInterpretation(bandh);
-        UNLOCK
+        BAND_METADATA(bm)
+        *color_interp = bm->color_interp;
         SUCCESS
     }
 
@@ -270,24 +326,21 @@ public:
      * @param widths The array in which to return the widths
      * @param heights The array in which to return the heights
      * @param max_length The maximum of number of widths and heights to return
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_overview_widths_heights(int dataset, int band_number, int *widths, int *heights, int max_length)
+    int get_overview_widths_heights(int dataset, int band_number, int *widths, int *heights, int max_length) const
     {
-        TRYLOCK
-        GDALRasterBandH band = GDALGetRasterBand(m_datasets[dataset], band_number);
-        int overview_count = GDALGetOverviewCount(band);
+        BAND_METADATA(bm)
+        int overview_count = static_cast<int>(bm->overviews.size());
         for (int i = 0; i < overview_count && i < max_length; ++i)
         {
-            GDALRasterBandH overview = GDALGetOverview(band, i);
-            widths[i] = GDALGetRasterBandXSize(overview);
-            heights[i] = GDALGetRasterBandYSize(overview);
+            widths[i] = bm->overviews[i].first;
+            heights[i] = bm->overviews[i].second;
         }
         for (int i = overview_count; i < max_length; ++i)
         {
             widths[i] = heights[i] = -1;
         }
-        UNLOCK
         SUCCESS
     }
 
@@ -297,18 +350,16 @@ public:
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param crs The location at-which to return the PROJ.4 string
      * @param max_size The maximum PROJ.4 string size
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_crs_proj4(int dataset, char *crs, int max_size)
+    int get_crs_proj4(int dataset, char *crs, int max_size) const
     {
-        TRYLOCK
         char *result;
-        OGRSpatialReferenceH ref = OSRNewSpatialReference(GDALGetProjectionRef(m_datasets[dataset]));
+        OGRSpatialReferenceH ref = OSRNewSpatialReference(m_metadata[dataset].crs_wkt().c_str());
         OSRExportToProj4(ref, &result);
         strncpy(crs, result, max_size);
         CPLFree(result);
         OSRDestroySpatialReference(ref);
-        UNLOCK
         SUCCESS
     }
 
@@ -318,13 +369,11 @@ public:
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param crs The location at-which to return the WKT string
      * @param max_size The maximum WKT string size
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_crs_wkt(int dataset, char *crs, int max_size)
+    int get_crs_wkt(int dataset, char *crs, int max_size) const
     {
-        TRYLOCK
-        strncpy(crs, GDALGetProjectionRef(m_datasets[dataset]), max_size);
-        UNLOCK
+        strncpy(crs, m_metadata[dataset].crs_wkt().c_str(), max_size);
         SUCCESS
     }
 
@@ -336,14 +385,13 @@ public:
      * @param band_number The band in question
      * @param nodata The return-location for the nodata value
      * @param success The return slot for the "is there nodata" value
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_band_nodata(int dataset, int band_number, double *nodata, int *success)
+    int get_band_nodata(int dataset, int band_number, double *nodata, int *success) const
     {
-        TRYLOCK
-        GDALRasterBandH bandh = GDALGetRasterBand(m_datasets[dataset], band_number);
-        *nodata = GDALGetRasterNoDataValue(bandh, success);
-        UNLOCK
+        BAND_METADATA(bm)
+        *nodata = bm->nodata;
+        *success = bm->has_nodata;
         SUCCESS
     }
 
@@ -354,14 +402,12 @@ public:
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param band_number The band in question
      * @param data_type The type of the band in question
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_band_data_type(int dataset, int band_number, GDALDataType *data_type)
+    int get_band_data_type(int dataset, int band_number, GDALDataType *data_type) const
     {
-        TRYLOCK
-        GDALRasterBandH bandh = GDALGetRasterBand(m_datasets[dataset], band_number);
-        *data_type = GDALGetRasterDataType(bandh);
-        UNLOCK
+        BAND_METADATA(bm)
+        *data_type = bm->data_type;
         SUCCESS
     }
 
@@ -371,13 +417,11 @@ public:
      *
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param band_count The return-location for the integer band count
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
     int get_band_count(int dataset, int *band_count) const
     {
-        TRYLOCK
-        *band_count = GDALGetRasterCount(m_datasets[dataset]);
-        UNLOCK
+        *band_count = m_metadata[dataset].band_count();
         SUCCESS
     }
 
@@ -386,13 +430,12 @@ public:
      *
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param transform The return-location of the transform
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
     int get_transform(int dataset, double transform[6]) const
     {
-        TRYLOCK
-        GDALGetGeoTransform(m_datasets[dataset], transform);
-        UNLOCK
+        auto t = m_metadata[dataset].transform();
+        std::copy(t, t + 6, transform);
         SUCCESS
     }
 
@@ -402,15 +445,27 @@ public:
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param width The return-location for the width
      * @param height The return-location for the height
-     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
      */
-    int get_width_height(int dataset, int *width, int *height)
+    int get_width_height(int dataset, int *width, int *height) const
     {
-        TRYLOCK
-        auto ds = m_datasets[dataset];
-        *width = GDALGetRasterXSize(ds);
-        *height = GDALGetRasterYSize(ds);
-        UNLOCK
+        *width = m_metadata[dataset].width();
+        *height = m_metadata[dataset].height();
+        SUCCESS
+    }
+
+    /**
+     * Get all of the immutable properties of the dataset in one
+     * record (see dataset_info.h for the layout).
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param info The return-location for the record
+     * @param max_size The size of the return buffer in bytes
+     * @return ATTEMPT_SUCCESSFUL or a negative CPLErrorNum
+     */
+    int get_info(int dataset, void *info, int max_size) const
+    {
+        m_metadata[dataset].serialize(info, max_size);
         SUCCESS
     }
 
@@ -553,7 +608,8 @@ public:
      * Read pixels from the underlying dataset.  This is more-or-less
      * a direct wrapper of the GDALRasterIO function see
      * https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
-     * for more information.
+     * for more information.  The read is abandoned if the deadline
+     * of the current thread (see deadline.hpp) passes.
      *
      * @param dataset The index of the dataset (source == 0, warped == 1)
      * @param src_window The pixel-space coordinates of the upper-left
@@ -574,9 +630,12 @@ public:
                    void *data) const
     {
         GDALRasterBandH band = GDALGetRasterBand(m_datasets[dataset], band_number);
+        GDALRasterIOExtraArg extra_arg;
+        INIT_RASTERIO_EXTRA_ARG(extra_arg);
+        extra_arg.pfnProgress = deadline_progress;
 
         TRYLOCK
-        auto retval = GDALRasterIO(
+        auto retval = GDALRasterIOEx(
             band,                         // source band
             GF_Read,                      // mode
             src_window[0], src_window[1], // read offsets
@@ -584,10 +643,462 @@ public:
             data,                         // write buffer
             dst_window[0], dst_window[1], // write width, height
             type,                         // destination type
-            0, 0                          // stride
+            0, 0,                         // stride
+            &extra_arg                    // extra arguments
+        );
+        UNLOCK
+
+        if (retval == CE_None)
+        {
+            SUCCESS
+        }
+        else
+        {
+            FAILURE
+        }
+    }
+
+    /**
+     * Read pixels from several bands of the underlying dataset in one
+     * call.  This is a wrapper around GDALDatasetRasterIOEx (see
+     * https://gdal.org/api/raster_c_api.html#_CPPv421GDALDatasetRasterIOEx12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPKi8GSpacing8GSpacing8GSpacingP20GDALRasterIOExtraArg)
+     * so a warped dataset only runs the warp kernel once for all of
+     * the requested bands.
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param src_window The pixel-space coordinates of the upper-left
+     *                   corner of the source window (the first two
+     *                   entries) and the width and height of the
+     *                   source window (the last two entries)
+     * @param dst_window The width and height of the destination buffer
+     * @param type The datatype of the destination buffer
+     * @param data A pointer to the destination buffer
+     * @param options The bands to read, the layout (interleaving
+     *                or explicit pixel, line and band spacing) of the
+     *                destination buffer, and optionally where to put
+     *                the validity mask of the first band (read under
+     *                the same lock, so it always matches the pixels)
+     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     */
+    int get_pixels_ex(int dataset,
+                      const int src_window[4],
+                      const int dst_window[2],
+                      GDALDataType type,
+                      void *data,
+                      const read_options_t *options) const
+    {
+        GSpacing spacing[3];
+        int band_count = layout(dataset, dst_window, type, options, spacing);
+        if (band_count <= 0)
+        {
+            return -CPLE_IllegalArg;
+        }
+
+        int mask_band = (options->band_list != nullptr) ? options->band_list[0] : 1;
+        auto unpacked = std::vector<uint8_t>();
+        uint8_t *mask = options->mask;
+        if (mask != nullptr && options->mask_packed)
+        {
+            unpacked.resize(static_cast<size_t>(dst_window[0]) * dst_window[1]);
+            mask = unpacked.data();
+        }
+
+        TRYLOCK
+        auto retval = read_window(dataset, src_window, dst_window, type, data, band_count, options, spacing);
+        if (retval == CE_None && mask != nullptr)
+        {
+            retval = read_mask(dataset, src_window, dst_window, mask_band, options, mask);
+        }
+        UNLOCK
+
+        if (retval == CE_None)
+        {
+            if (!unpacked.empty())
+            {
+                pack_mask(unpacked.data(), unpacked.size(), options->mask);
+            }
+            SUCCESS
+        }
+        else
+        {
+            FAILURE
+        }
+    }
+
+    /**
+     * Read a batch of windows from the underlying dataset while
+     * holding the lock only once.  The windows are read in the block
+     * order of the source (top-to-bottom, left-to-right by block,
+     * using the block size of the first requested band) so that
+     * consecutive reads reuse GDAL's block cache and, for remote
+     * files, neighbouring byte ranges.
+     *
+     * The batch can be resumed: the permutation in which the windows
+     * are read is computed (into order) when *next is zero, and *next
+     * is advanced past each window that has been read, so a batch
+     * interrupted by an error can be retried on another copy of the
+     * dataset without repeating completed reads.
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param count The number of windows
+     * @param src_windows The source windows (four entries per window,
+     *                    see get_pixels_ex)
+     * @param dst_windows The destination sizes (two entries per
+     *                    window)
+     * @param type The datatype of the destination buffers
+     * @param data The destination buffers (one per window)
+     * @param options The bands to read and the layout of the
+     *                destination buffers (shared by all windows)
+     * @param order The return-location of the read order (count entries)
+     * @param next The position in the read order of the next window
+     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     */
+    int get_pixels_batch(int dataset,
+                         int count,
+                         const int *src_windows,
+                         const int *dst_windows,
+                         GDALDataType type,
+                         void *const *data,
+                         const read_options_t *options,
+                         int *order,
+                         int *next) const
+    {
+        if (*next == 0)
+        {
+            int band_number = (options->band_count > 0 && options->band_list != nullptr) ? options->band_list[0] : 1;
+            block_order(dataset, band_number, count, src_windows, order);
+        }
+
+        TRYLOCK
+        for (; *next < count; ++(*next))
+        {
+            int i = order[*next];
+            GSpacing spacing[3];
+            int band_count = layout(dataset, dst_windows + 2 * i, type, options, spacing);
+            if (band_count <= 0)
+            {
+                UNLOCK
+                return -CPLE_IllegalArg;
+            }
+            auto retval = read_window(dataset, src_windows + 4 * i, dst_windows + 2 * i, type, data[i],
+                                      band_count, options, spacing);
+            if (retval != CE_None)
+            {
+                UNLOCK
+                FAILURE
+            }
+        }
+        UNLOCK
+
+        SUCCESS
+    }
+
+    /**
+     * Read the validity mask of a band (see
+     * https://gdal.org/development/rfc/rfc15_nodatabitmask.html).
+     * Non-zero entries mark valid pixels.
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param src_window The source window (see get_pixels)
+     * @param dst_window The width and height of the destination buffer
+     * @param band_number The band whose mask is wanted
+     * @param mask A pointer to the destination buffer (one byte per pixel)
+     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     */
+    int get_mask(int dataset,
+                 const int src_window[4],
+                 const int dst_window[2],
+                 int band_number,
+                 uint8_t *mask) const
+    {
+        BAND_METADATA(bm)
+
+        read_options_t options;
+        INIT_READ_OPTIONS(options);
+
+        TRYLOCK
+        CPLErr retval = read_mask(dataset, src_window, dst_window, band_number, &options, mask);
+        UNLOCK
+
+        if (retval == CE_None)
+        {
+            SUCCESS
+        }
+        else
+        {
+            FAILURE
+        }
+    }
+
+    /**
+     * Warp the source dataset onto an arbitrary target grid, without
+     * building (or caching) a warped VRT for that grid.  The caller's
+     * buffer is wrapped in a MEM dataset and filled by a
+     * GDALWarpOperation whose source is the (locked) source dataset.
+     * Pixels that no source pixel maps to are set to the NODATA value
+     * of the source band, if it has one, and zero otherwise.
+     *
+     * When a transformer cache is given, the PROJ transformations
+     * between the two CRSs are taken from it, so that warping many
+     * scenes in the same projection solves the PROJ pipelines once.
+     *
+     * @param dst_wkt The WKT of the target CRS
+     * @param dst_transform The geotransform of the target grid
+     * @param dst_size The width and height of the target grid
+     * @param resample The resampling algorithm
+     * @param type The datatype of the destination buffer
+     * @param data A pointer to the destination buffer
+     * @param options The bands to read and the layout of the
+     *                destination buffer
+     * @param transformers A cache of coordinate transformations to
+     *                     use when the source dataset has a
+     *                     geotransform and a CRS (nullptr to always
+     *                     build a new transformer)
+     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     */
+    int warp_into(const char *dst_wkt,
+                  const double dst_transform[6],
+                  const int dst_size[2],
+                  GDALResampleAlg resample,
+                  GDALDataType type,
+                  void *data,
+                  const read_options_t *options,
+                  transformer_cache *transformers) const
+    {
+        if (options->band_list != nullptr && options->band_count <= 0)
+        {
+            return -CPLE_IllegalArg;
+        }
+        GSpacing spacing[3];
+        int band_count = layout(SOURCE, dst_size, type, options, spacing);
+        if (band_count <= 0)
+        {
+            return -CPLE_IllegalArg;
+        }
+        for (int i = 0; i < band_count; ++i)
+        {
+            if (m_metadata[SOURCE].band((options->band_list != nullptr) ? options->band_list[i] : i + 1) == nullptr)
+            {
+                return -CPLE_IllegalArg;
+            }
+        }
+
+        // The destination: a MEM dataset over the caller's buffer
+        GDALDatasetH dst = GDALCreate(GDALGetDriverByName("MEM"), "", dst_size[0], dst_size[1], 0, type, nullptr);
+        if (dst == nullptr)
+        {
+            FAILURE
+        }
+        GDALSetGeoTransform(dst, const_cast<double *>(dst_transform));
+        GDALSetProjection(dst, dst_wkt);
+        for (int i = 0; i < band_count; ++i)
+        {
+            char pointer[64], pixel_offset[64], line_offset[64];
+            snprintf(pointer, sizeof(pointer), "DATAPOINTER=%p", static_cast<void *>(static_cast<uint8_t *>(data) + i * spacing[2]));
+            snprintf(pixel_offset, sizeof(pixel_offset), "PIXELOFFSET=%lld", static_cast<long long>(spacing[0]));
+            snprintf(line_offset, sizeof(line_offset), "LINEOFFSET=%lld", static_cast<long long>(spacing[1]));
+            const char *band_options[] = {pointer, pixel_offset, line_offset, nullptr};
+            GDALAddBand(dst, type, const_cast<char **>(band_options));
+        }
+
+        auto warp_options = GDALCreateWarpOptions();
+        bool any_nodata = false;
+        warp_options->eResampleAlg = resample;
+        warp_options->pfnProgress = deadline_progress;
+        warp_options->hDstDS = dst;
+        warp_options->nBandCount = band_count;
+        warp_options->panSrcBands = static_cast<int *>(CPLMalloc(sizeof(int) * band_count));
+        warp_options->panDstBands = static_cast<int *>(CPLMalloc(sizeof(int) * band_count));
+        warp_options->padfSrcNoDataReal = static_cast<double *>(CPLMalloc(sizeof(double) * band_count));
+        warp_options->padfDstNoDataReal = static_cast<double *>(CPLMalloc(sizeof(double) * band_count));
+        for (int i = 0; i < band_count; ++i)
+        {
+            int band_number = (options->band_list != nullptr) ? options->band_list[i] : i + 1;
+            auto bm = m_metadata[SOURCE].band(band_number);
+            warp_options->panSrcBands[i] = band_number;
+            warp_options->panDstBands[i] = i + 1;
+            // Bands without NODATA get NaN (as gdalwarp does for "None"),
+            // which no integer pixel matches
+            warp_options->padfSrcNoDataReal[i] = warp_options->padfDstNoDataReal[i] =
+                bm->has_nodata ? bm->nodata : std::numeric_limits<double>::quiet_NaN();
+            any_nodata = any_nodata || bm->has_nodata;
+        }
+        if (!any_nodata)
+        {
+            CPLFree(warp_options->padfSrcNoDataReal);
+            CPLFree(warp_options->padfDstNoDataReal);
+            warp_options->padfSrcNoDataReal = warp_options->padfDstNoDataReal = nullptr;
+        }
+        else
+        {
+            // A NODATA pixel in one band does not invalidate the others
+            warp_options->papszWarpOptions = CSLSetNameValue(warp_options->papszWarpOptions, "UNIFIED_SRC_NODATA", "NO");
+        }
+        warp_options->papszWarpOptions = CSLSetNameValue(warp_options->papszWarpOptions, "INIT_DEST", any_nodata ? "NO_DATA" : "0");
+
+        // Geotransform-to-geotransform warps can use cached transformations
+        const auto &src_wkt = m_metadata[SOURCE].crs_wkt();
+        auto grid_transformer = grid_transformer_t();
+        bool cached = false;
+        if (transformers != nullptr && m_metadata[SOURCE].has_transform() && !src_wkt.empty() &&
+            transformers->checkout(src_wkt, dst_wkt, &grid_transformer.transformations))
+        {
+            cached = grid_transformer_init(&grid_transformer,
+                                           m_metadata[SOURCE].transform(), dst_transform,
+                                           grid_transformer.transformations);
+            if (!cached)
+            {
+                transformers->checkin(src_wkt, dst_wkt, grid_transformer.transformations);
+            }
+        }
+
+        CPLErr retval = CE_Failure;
+        if (pthread_mutex_trylock(&m_dataset_lock) != 0)
+        {
+            if (cached)
+            {
+                transformers->checkin(src_wkt, dst_wkt, grid_transformer.transformations);
+            }
+            GDALDestroyWarpOptions(warp_options);
+            GDALClose(dst);
+            return DATASET_LOCKED;
+        }
+        warp_options->hSrcDS = m_datasets[SOURCE];
+        if (cached)
+        {
+            warp_options->pTransformerArg = GDALCreateApproxTransformer(grid_transform, &grid_transformer, 0.125);
+            warp_options->pfnTransformer = GDALApproxTransform;
+        }
+        else
+        {
+            void *transformer = GDALCreateGenImgProjTransformer2(m_datasets[SOURCE], dst, nullptr);
+            if (transformer != nullptr)
+            {
+                warp_options->pTransformerArg = GDALCreateApproxTransformer(GDALGenImgProjTransform, transformer, 0.125);
+                warp_options->pfnTransformer = GDALApproxTransform;
+                GDALApproxTransformerOwnsSubtransformer(warp_options->pTransformerArg, TRUE);
+            }
+        }
+        if (warp_options->pTransformerArg != nullptr)
+        {
+            auto operation = GDALCreateWarpOperation(warp_options);
+            if (operation != nullptr)
+            {
+                retval = GDALChunkAndWarpImage(operation, 0, 0, dst_size[0], dst_size[1]);
+                GDALDestroyWarpOperation(operation);
+            }
+        }
+        UNLOCK
+
+        if (warp_options->pTransformerArg != nullptr)
+        {
+            GDALDestroyApproxTransformer(warp_options->pTransformerArg);
+        }
+        if (cached)
+        {
+            transformers->checkin(src_wkt, dst_wkt, grid_transformer.transformations);
+        }
+        GDALDestroyWarpOptions(warp_options);
+        GDALClose(dst);
+
+        if (retval == CE_None)
+        {
+            SUCCESS
+        }
+        else
+        {
+            FAILURE
+        }
+    }
+
+    /**
+     * Tell GDAL that a window is about to be read (see
+     * GDALDatasetAdviseRead) and, optionally, read it once so that
+     * its blocks are in the block cache and, for remote files, its
+     * byte ranges are in the /vsicurl/ region cache (which is shared
+     * by every copy of the dataset).
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param src_window The window (see get_pixels)
+     * @param band_count The number of bands (zero for all bands)
+     * @param band_list The bands (nullptr for 1 ... band_count)
+     * @param warm Whether to read the window as well
+     * @return ATTEMPT_SUCCESSFUL, DATASET_LOCKED, or a negative CPLErrorNum
+     */
+    int prefetch(int dataset,
+                 const int src_window[4],
+                 int band_count,
+                 const int *band_list,
+                 bool warm) const
+    {
+        auto bands = std::vector<int>();
+        if (band_count <= 0)
+        {
+            for (int i = 1; i <= m_metadata[dataset].band_count(); ++i)
+            {
+                bands.push_back(i);
+            }
+        }
+        else if (band_list == nullptr)
+        {
+            for (int i = 1; i <= band_count; ++i)
+            {
+                bands.push_back(i);
+            }
+        }
+        else
+        {
+            bands.assign(band_list, band_list + band_count);
+        }
+        for (auto band_number : bands)
+        {
+            BAND_METADATA(bm)
+        }
+        if (bands.empty())
+        {
+            SUCCESS
+        }
+        auto type = m_metadata[dataset].band(bands[0])->data_type;
+
+        TRYLOCK
+        auto retval = GDALDatasetAdviseRead(
+            m_datasets[dataset],                          // dataset
+            src_window[0], src_window[1],                 // read offsets
+            src_window[2], src_window[3],                 // read width, height
+            src_window[2], src_window[3],                 // buffer width, height
+            type,                                         // buffer type
+            static_cast<int>(bands.size()), bands.data(), // bands
+            nullptr                                       // options
         );
         UNLOCK
 
+        // Read one strip of blocks at a time to bound the scratch space,
+        // taking the lock for each strip so that a foreground read of
+        // this copy waits for one strip at most.  Warming is
+        // best-effort: it stops quietly if a reader holds the copy or
+        // the deadline passes.
+        for (size_t i = 0; warm && retval == CE_None && i < bands.size(); ++i)
+        {
+            auto bm = m_metadata[dataset].band(bands[i]);
+            auto band = GDALGetRasterBand(m_datasets[dataset], bands[i]);
+            int strip = std::max(bm->block_height, 1);
+            auto scratch = std::vector<uint8_t>(static_cast<size_t>(src_window[2]) * strip *
+                                                GDALGetDataTypeSizeBytes(bm->data_type));
+            for (int y = 0; retval == CE_None && y < src_window[3]; y += strip)
+            {
+                int height = std::min(strip, src_window[3] - y);
+                if (deadline_passed(current_deadline()) || pthread_mutex_trylock(&m_dataset_lock) != 0)
+                {
+                    SUCCESS
+                }
+                retval = GDALRasterIO(band, GF_Read,
+                                      src_window[0], src_window[1] + y, src_window[2], height,
+                                      scratch.data(), src_window[2], height, bm->data_type,
+                                      0, 0);
+                UNLOCK
+            }
+        }
+
         if (retval == CE_None)
         {
             SUCCESS
@@ -729,6 +1240,12 @@ private:
             }
 
             GDALWarpAppOptionsFree(app_options);
+
+            if (valid())
+            {
+                m_metadata[SOURCE] = dataset_metadata(m_datasets[SOURCE]);
+                m_metadata[WARPED] = dataset_metadata(m_datasets[WARPED]);
+            }
         }
         UNLOCK
     }
@@ -752,6 +1269,297 @@ private:
                 m_datasets[SOURCE] = nullptr;
             }
         }
+        m_metadata[SOURCE] = m_metadata[WARPED] = dataset_metadata();
+    }
+
+    /**
+     * Compute the byte spacing of a destination buffer from the
+     * interleaving and any explicit spacings given in the options.
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param dst_window The width and height of the destination buffer
+     * @param type The datatype of the destination buffer
+     * @param options The bands to read and the layout of the
+     *                destination buffer
+     * @param spacing The return-location of the pixel, line, and band
+     *                spacing
+     * @return The number of bands to read, or zero if the layout or
+     *         resampling algorithm is not recognized, the fractional
+     *         window is malformed, a requested band or overview does
+     *         not exist, or a band list is given without a positive
+     *         band count
+     */
+    int layout(int dataset,
+               const int dst_window[2],
+               GDALDataType type,
+               const read_options_t *options,
+               GSpacing spacing[3]) const
+    {
+        int band_count = options->band_count;
+        if (band_count <= 0)
+        {
+            // "All bands" cannot be read through a band list of unknown length
+            if (options->band_list != nullptr)
+            {
+                return 0;
+            }
+            band_count = m_metadata[dataset].band_count();
+        }
+        if (options->overview >= 0)
+        {
+            for (int i = 0; i < band_count; ++i)
+            {
+                auto bm = m_metadata[dataset].band((options->band_list != nullptr) ? options->band_list[i] : i + 1);
+                if (bm == nullptr || options->overview >= static_cast<int>(bm->overviews.size()))
+                {
+                    return 0;
+                }
+            }
+        }
+
+        switch (options->resampling)
+        {
+        case GRIORA_NearestNeighbour:
+        case GRIORA_Bilinear:
+        case GRIORA_Cubic:
+        case GRIORA_CubicSpline:
+        case GRIORA_Lanczos:
+        case GRIORA_Average:
+        case GRIORA_Mode:
+        case GRIORA_Gauss:
+        case GRIORA_RMS:
+            break;
+        default:
+            return 0;
+        }
+        if (options->has_fractional_window)
+        {
+            const double *window = options->fractional_window;
+            if (!(window[0] >= 0) || !(window[1] >= 0) || !(window[2] > 0) || !(window[3] > 0))
+            {
+                return 0;
+            }
+        }
+
+        GSpacing size = GDALGetDataTypeSizeBytes(type);
+        switch (options->interleave)
+        {
+        case INTERLEAVE_BAND:
+            spacing[0] = size;
+            spacing[1] = size * dst_window[0];
+            spacing[2] = spacing[1] * dst_window[1];
+            break;
+        case INTERLEAVE_PIXEL:
+            spacing[0] = size * band_count;
+            spacing[1] = spacing[0] * dst_window[0];
+            spacing[2] = size;
+            break;
+        case INTERLEAVE_LINE:
+            spacing[0] = size;
+            spacing[1] = size * dst_window[0] * band_count;
+            spacing[2] = size * dst_window[0];
+            break;
+        default:
+            return 0;
+        }
+        // Explicit spacings (for writing into a larger or padded
+        // buffer) override those implied by the layout
+        const GSpacing explicit_spacing[3] = {options->pixel_space, options->line_space, options->band_space};
+        for (int i = 0; i < 3; ++i)
+        {
+            if (explicit_spacing[i] != 0)
+            {
+                spacing[i] = explicit_spacing[i];
+            }
+        }
+
+        return band_count;
+    }
+
+    /**
+     * Initialize the extra RasterIO arguments for a read and compute
+     * its integer source window: the given one, or the smallest one
+     * that encloses the fractional window (if any).
+     *
+     * @param src_window_in The integer source window
+     * @param options The read options
+     * @param src_window The return-location of the source window
+     * @param extra_arg The return-location of the extra arguments
+     */
+    static void prepare_window(const int src_window_in[4],
+                               const read_options_t *options,
+                               int src_window[4],
+                               GDALRasterIOExtraArg *extra_arg)
+    {
+        std::copy(src_window_in, src_window_in + 4, src_window);
+        INIT_RASTERIO_EXTRA_ARG(*extra_arg);
+        extra_arg->pfnProgress = deadline_progress;
+        if (options->has_fractional_window)
+        {
+            const double *window = options->fractional_window;
+            extra_arg->bFloatingPointWindowValidity = TRUE;
+            extra_arg->dfXOff = window[0];
+            extra_arg->dfYOff = window[1];
+            extra_arg->dfXSize = window[2];
+            extra_arg->dfYSize = window[3];
+            src_window[0] = static_cast<int>(std::floor(window[0]));
+            src_window[1] = static_cast<int>(std::floor(window[1]));
+            src_window[2] = std::max(static_cast<int>(std::ceil(window[0] + window[2])) - src_window[0], 1);
+            src_window[3] = std::max(static_cast<int>(std::ceil(window[1] + window[3])) - src_window[1], 1);
+        }
+    }
+
+    /**
+     * Read one window.  The caller must hold the lock.  This is a
+     * thin wrapper around GDALDatasetRasterIOEx or, when an overview
+     * is requested, around GDALRasterIOEx on that overview of each
+     * band.  The resampling algorithm and fractional source window
+     * (if any) are passed to GDAL through GDALRasterIOExtraArg; in
+     * the latter case the integer source window is replaced by the
+     * smallest one that encloses the fractional one.
+     *
+     * @return The CPLErr returned by GDAL
+     */
+    CPLErr read_window(int dataset,
+                       const int src_window_in[4],
+                       const int dst_window[2],
+                       GDALDataType type,
+                       void *data,
+                       int band_count,
+                       const read_options_t *options,
+                       const GSpacing spacing[3]) const
+    {
+        GDALRasterIOExtraArg extra_arg;
+        int src_window[4];
+
+        prepare_window(src_window_in, options, src_window, &extra_arg);
+        extra_arg.eResampleAlg = static_cast<GDALRIOResampleAlg>(options->resampling);
+
+        if (options->overview < 0)
+        {
+            return GDALDatasetRasterIOEx(
+                m_datasets[dataset],                   // source dataset
+                GF_Read,                               // mode
+                src_window[0], src_window[1],          // read offsets
+                src_window[2], src_window[3],          // read width, height
+                data,                                  // write buffer
+                dst_window[0], dst_window[1],          // write width, height
+                type,                                  // destination type
+                band_count,                            // band count
+                const_cast<int *>(options->band_list), // bands
+                spacing[0], spacing[1], spacing[2],    // stride
+                &extra_arg                             // extra arguments
+            );
+        }
+
+        CPLErr retval = CE_None;
+        for (int i = 0; retval == CE_None && i < band_count; ++i)
+        {
+            int band_number = (options->band_list != nullptr) ? options->band_list[i] : i + 1;
+            GDALRasterBandH band = GDALGetRasterBand(m_datasets[dataset], band_number);
+            auto buffer = static_cast<uint8_t *>(data) + i * spacing[2];
+            retval = GDALRasterIOEx(
+                GDALGetOverview(band, options->overview), // source band
+                GF_Read,                                  // mode
+                src_window[0], src_window[1],             // read offsets
+                src_window[2], src_window[3],             // read width, height
+                buffer,                                   // write buffer
+                dst_window[0], dst_window[1],             // write width, height
+                type,                                     // destination type
+                spacing[0], spacing[1],                   // stride
+                &extra_arg                                // extra arguments
+            );
+        }
+        return retval;
+    }
+
+    /**
+     * Read the validity mask of one band (one byte per pixel) over
+     * the same window, overview and fractional window as read_window.
+     * The mask is always resampled with nearest neighbour.  The caller
+     * must hold the lock.
+     *
+     * @return The CPLErr returned by GDAL
+     */
+    CPLErr read_mask(int dataset,
+                     const int src_window_in[4],
+                     const int dst_window[2],
+                     int band_number,
+                     const read_options_t *options,
+                     uint8_t *mask) const
+    {
+        GDALRasterBandH band = GDALGetRasterBand(m_datasets[dataset], band_number);
+        if (options->overview >= 0)
+        {
+            band = GDALGetOverview(band, options->overview);
+        }
+        if (GDALGetMaskFlags(band) & GMF_ALL_VALID)
+        {
+            memset(mask, 0xff, static_cast<size_t>(dst_window[0]) * dst_window[1]);
+            return CE_None;
+        }
+
+        GDALRasterIOExtraArg extra_arg;
+        int src_window[4];
+        prepare_window(src_window_in, options, src_window, &extra_arg);
+
+        return GDALRasterIOEx(
+            GDALGetMaskBand(band),        // source band
+            GF_Read,                      // mode
+            src_window[0], src_window[1], // read offsets
+            src_window[2], src_window[3], // read width, height
+            mask,                         // write buffer
+            dst_window[0], dst_window[1], // write width, height
+            GDT_Byte,                     // destination type
+            0, 0,                         // stride
+            &extra_arg                    // extra arguments
+        );
+    }
+
+    /**
+     * Pack a byte-per-pixel mask into one bit per pixel (see MASK_BYTES).
+     *
+     * @param mask The unpacked mask
+     * @param n The number of pixels
+     * @param packed The return-location of the packed mask
+     */
+    static void pack_mask(const uint8_t *mask, size_t n, uint8_t *packed)
+    {
+        memset(packed, 0, (n + 7) / 8);
+        for (size_t i = 0; i < n; ++i)
+        {
+            packed[i >> 3] |= static_cast<uint8_t>((mask[i] != 0) << (i & 7));
+        }
+    }
+
+    /**
+     * Sort a list of windows into the block order of the given band
+     * (by block row, then block column, then by position).
+     *
+     * @param dataset The index of the dataset (source == 0, warped == 1)
+     * @param band_number The band whose block size is used
+     * @param count The number of windows
+     * @param src_windows The windows (four entries per window)
+     * @param order The return-location of the sorted window indices
+     */
+    void block_order(int dataset, int band_number, int count, const int *src_windows, int *order) const
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            order[i] = i;
+        }
+
+        auto bm = m_metadata[dataset].band(band_number);
+        if (bm == nullptr || bm->block_width <= 0 || bm->block_height <= 0)
+        {
+            return;
+        }
+
+        auto key = [&](int i) {
+            const int *w = src_windows + 4 * i;
+            return std::make_tuple(w[1] / bm->block_height, w[0] / bm->block_width, w[1], w[0]);
+        };
+        std::stable_sort(order, order + count, [&](int a, int b) { return key(a) < key(b); });
     }
 
 public:
@@ -760,6 +1568,7 @@ public:
 
 private:
     GDALDatasetH m_datasets[2];
+    dataset_metadata m_metadata[2];
     uri_options_t m_uri_options;
     mutable pthread_mutex_t m_dataset_lock;
     atomic_int_t m_use_count;
@@ -782,5 +1591,6 @@ struct hash<locked_dataset>
 #undef UNLOCK
 #undef SUCCESS
 #undef FAILURE
+#undef BAND_METADATA
 
 #endif
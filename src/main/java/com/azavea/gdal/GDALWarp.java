@@ -17,6 +17,11 @@
 package com.azavea.gdal;
 
 import java.io.UnsupportedEncodingException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.concurrent.CompletableFuture;
 
 import cz.adamh.utils.NativeUtils;
 
@@ -63,12 +68,66 @@ public class GDALWarp {
         public static final int SOURCE = 0;
         public static final int WARPED = 1;
 
+        public static final int INTERLEAVE_BAND = 0;
+        public static final int INTERLEAVE_PIXEL = 1;
+        public static final int INTERLEAVE_LINE = 2;
+
+        public static final int GRIORA_NearestNeighbour = 0;
+        public static final int GRIORA_Bilinear = 1;
+        public static final int GRIORA_Cubic = 2;
+        public static final int GRIORA_CubicSpline = 3;
+        public static final int GRIORA_Lanczos = 4;
+        public static final int GRIORA_Average = 5;
+        public static final int GRIORA_Mode = 6;
+        public static final int GRIORA_Gauss = 7;
+        public static final int GRIORA_RMS = 14;
+
+        public static final int GRA_NearestNeighbour = 0;
+        public static final int GRA_Bilinear = 1;
+        public static final int GRA_Cubic = 2;
+        public static final int GRA_CubicSpline = 3;
+        public static final int GRA_Lanczos = 4;
+        public static final int GRA_Average = 5;
+        public static final int GRA_Mode = 6;
+        public static final int GRA_Max = 8;
+        public static final int GRA_Min = 9;
+        public static final int GRA_Med = 10;
+        public static final int GRA_Q1 = 11;
+        public static final int GRA_Q3 = 12;
+        public static final int GRA_Sum = 13;
+        public static final int GRA_RMS = 14;
+
+        // Layout of the record returned by get_info (see dataset_info.h)
+        public static final int INFO_HEADER_SIZE = 72;
+        public static final int INFO_SIZE = 0;
+        public static final int INFO_WIDTH = 4;
+        public static final int INFO_HEIGHT = 8;
+        public static final int INFO_BAND_COUNT = 12;
+        public static final int INFO_CRS_WKT_LENGTH = 16;
+        public static final int INFO_TRANSFORM = 24;
+        public static final int INFO_BAND_SIZE = 56;
+        public static final int INFO_BAND_DATA_TYPE = 0;
+        public static final int INFO_BAND_COLOR_INTERP = 4;
+        public static final int INFO_BAND_BLOCK_WIDTH = 8;
+        public static final int INFO_BAND_BLOCK_HEIGHT = 12;
+        public static final int INFO_BAND_HAS_NODATA = 16;
+        public static final int INFO_BAND_HAS_OFFSET = 20;
+        public static final int INFO_BAND_HAS_SCALE = 24;
+        public static final int INFO_BAND_OVERVIEW_COUNT = 28;
+        public static final int INFO_BAND_NODATA = 32;
+        public static final int INFO_BAND_OFFSET = 40;
+        public static final int INFO_BAND_SCALE = 48;
+
         private static final String ANSI_RESET = "\u001B[0m";
         private static final String ANSI_RED = "\u001B[31m";
 
         private static ThreadLocal<byte[]> scratch_1d = new ThreadLocal<>();
         private static ThreadLocal<byte[][]> scratch_2d = new ThreadLocal<>();
 
+        private static final Object async_lock = new Object();
+        private static final HashMap<Long, CompletableFuture<Integer>> async_pending = new HashMap<>();
+        private static Thread async_poller = null;
+
         private static native void _init(int size);
 
         private static int ensure_scratch_1d() {
@@ -192,6 +251,24 @@ public class GDALWarp {
          */
         public static native void set_config_option(String key, String value);
 
+        /**
+         * Choose the byte order of the multi-byte pixels returned in byte arrays.
+         * By default they are big-endian (the order of the JVM); in native order
+         * the byte swap is skipped entirely, and the arrays should be read through
+         * ByteBuffer.wrap(data).order(ByteOrder.nativeOrder()). The setting is
+         * process-wide and may also be enabled with GDALWARP_NATIVE_ORDER.
+         *
+         * @param native_order Whether to leave pixels in native byte order
+         */
+        public static native void set_native_order(boolean native_order);
+
+        /**
+         * Whether multi-byte pixels are returned in native byte order.
+         *
+         * @return The current setting (see set_native_order)
+         */
+        public static native boolean get_native_order();
+
         /**
          * Return an unused token for the given uri, options pair. This is not a
          * function: two subsequent calls to it with the same pair as input may produce
@@ -236,9 +313,32 @@ public class GDALWarp {
          * @param approx_ok            Whether to accept an approximate histogram. With
          *                             COGs, will cause the use of overviews
          */
-        public static native int get_histogram(long token, int dataset, int attempts, /* */
+        public static int get_histogram(long token, int dataset, int attempts, /* */
+                        int band_number, double min, double max, long[] histogram_container,
+                        boolean include_out_of_range, boolean approx_ok) {
+                return _get_histogram(token, dataset, attempts, band_number, min, max, histogram_container,
+                                include_out_of_range, approx_ok, 0);
+        }
+
+        /**
+         * Like get_histogram, but with a deadline for the whole scan.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded
+         * @see #get_histogram(long, int, int, int, double, double, long[], boolean,
+         *      boolean)
+         */
+        public static int get_histogram(long token, int dataset, int attempts, /* */
+                        int band_number, double min, double max, long[] histogram_container,
+                        boolean include_out_of_range, boolean approx_ok, long nanos) {
+                return _get_histogram(token, dataset, attempts, band_number, min, max, histogram_container,
+                                include_out_of_range, approx_ok, nanos);
+        }
+
+        private static native int _get_histogram(long token, int dataset, int attempts, /* */
                         int band_number, double min, double max, long[] histogram_container,
-                        boolean include_out_of_range, boolean approx_ok);
+                        boolean include_out_of_range, boolean approx_ok, long nanos);
 
         /**
          * Get the offset of the given band.
@@ -312,8 +412,13 @@ public class GDALWarp {
          * @return The number of attempts made (upon success) or a negative error code
          *         (upon failure)
          */
-        public static native int get_metadata_domain_list(long token, int dataset, int attempts, /* */
-                        int band_number, byte[][] domain_list);
+        public static int get_metadata_domain_list(long token, int dataset, int attempts, /* */
+                        int band_number, byte[][] domain_list) {
+                return _get_metadata_domain_list(token, dataset, attempts, band_number, domain_list, 0);
+        }
+
+        private static native int _get_metadata_domain_list(long token, int dataset, int attempts, /* */
+                        int band_number, byte[][] domain_list, long nanos);
 
         /**
          * Get the list of metadata domain lists.
@@ -329,8 +434,22 @@ public class GDALWarp {
          */
         public static int get_metadata_domain_list(long token, int dataset, int attempts, int band_number,
                         String[][] domain_list) throws UnsupportedEncodingException {
+                return get_metadata_domain_list(token, dataset, attempts, band_number, domain_list, 0);
+        }
+
+        /**
+         * Like get_metadata_domain_list, but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded
+         * @see #get_metadata_domain_list(long, int, int, int, String[][])
+         */
+        public static int get_metadata_domain_list(long token, int dataset, int attempts, int band_number,
+                        String[][] domain_list, long nanos) throws UnsupportedEncodingException {
                 int array_len = ensure_scratch_2d();
-                int retval = get_metadata_domain_list(token, dataset, attempts, band_number, scratch_2d.get());
+                int retval = _get_metadata_domain_list(token, dataset, attempts, band_number, scratch_2d.get(),
+                                nanos);
 
                 if (retval >= 0) {
                         int n = 0;
@@ -347,7 +466,7 @@ public class GDALWarp {
                         return retval;
                 } else if (retval == -1) { // CPLE_AppDefined means array too small
                         grow_scratch_2d(0);
-                        return get_metadata_domain_list(token, dataset, attempts, band_number, domain_list);
+                        return get_metadata_domain_list(token, dataset, attempts, band_number, domain_list, nanos);
                 } else { // Return other error code
                         return retval;
                 }
@@ -366,8 +485,13 @@ public class GDALWarp {
          * @return The number of attempts made (upon success) or a negative error code
          *         (upon failure)
          */
-        public static native int get_metadata(long token, int dataset, int attempts, /* */
-                        int band_number, String domain, byte[][] list);
+        public static int get_metadata(long token, int dataset, int attempts, /* */
+                        int band_number, String domain, byte[][] list) {
+                return _get_metadata(token, dataset, attempts, band_number, domain, list, 0);
+        }
+
+        private static native int _get_metadata(long token, int dataset, int attempts, /* */
+                        int band_number, String domain, byte[][] list, long nanos);
 
         /**
          * Get the metadata found in a particular metadata domain.
@@ -384,8 +508,21 @@ public class GDALWarp {
          */
         public static int get_metadata(long token, int dataset, int attempts, int band_number, String domain,
                         String[][] list) throws UnsupportedEncodingException {
+                return get_metadata(token, dataset, attempts, band_number, domain, list, 0);
+        }
+
+        /**
+         * Like get_metadata, but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded
+         * @see #get_metadata(long, int, int, int, String, String[][])
+         */
+        public static int get_metadata(long token, int dataset, int attempts, int band_number, String domain,
+                        String[][] list, long nanos) throws UnsupportedEncodingException {
                 int array_len = ensure_scratch_2d();
-                int retval = get_metadata(token, dataset, attempts, band_number, domain, scratch_2d.get());
+                int retval = _get_metadata(token, dataset, attempts, band_number, domain, scratch_2d.get(), nanos);
 
                 if (retval >= 0) {
                         int n = 0;
@@ -402,7 +539,7 @@ public class GDALWarp {
                         return retval;
                 } else if (retval == -1) { // CPLE_AppDefined means array too small
                         grow_scratch_2d(0);
-                        return get_metadata(token, dataset, attempts, band_number, domain, list);
+                        return get_metadata(token, dataset, attempts, band_number, domain, list, nanos);
                 } else { // Return other error code
                         return retval;
                 }
@@ -422,8 +559,13 @@ public class GDALWarp {
          * @return The number of attempts made (upon success) or a negative error code
          *         (upon failure)
          */
-        public static native int get_metadata_item(long token, int dataset, int attempts, /* */
-                        int band_number, String key, String domain, byte[] value);
+        public static int get_metadata_item(long token, int dataset, int attempts, /* */
+                        int band_number, String key, String domain, byte[] value) {
+                return _get_metadata_item(token, dataset, attempts, band_number, key, domain, value, 0);
+        }
+
+        private static native int _get_metadata_item(long token, int dataset, int attempts, /* */
+                        int band_number, String key, String domain, byte[] value, long nanos);
 
         /**
          * Get a particular metadata value associated with a key.
@@ -441,8 +583,22 @@ public class GDALWarp {
          */
         public static int get_metadata_item(long token, int dataset, int attempts, int band_number, String key,
                         String domain, String[] value) throws UnsupportedEncodingException {
+                return get_metadata_item(token, dataset, attempts, band_number, key, domain, value, 0);
+        }
+
+        /**
+         * Like get_metadata_item, but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded
+         * @see #get_metadata_item(long, int, int, int, String, String, String[])
+         */
+        public static int get_metadata_item(long token, int dataset, int attempts, int band_number, String key,
+                        String domain, String[] value, long nanos) throws UnsupportedEncodingException {
                 int array_len = ensure_scratch_1d();
-                int retval = get_metadata_item(token, dataset, attempts, band_number, key, domain, scratch_1d.get());
+                int retval = _get_metadata_item(token, dataset, attempts, band_number, key, domain, scratch_1d.get(),
+                                nanos);
 
                 if (retval >= 0) {
                         int m = 0;
@@ -453,7 +609,7 @@ public class GDALWarp {
                         return retval;
                 } else if (retval == -1) { // CPLE_AppDefined means array too small
                         grow_scratch_1d(0);
-                        return get_metadata_item(token, dataset, attempts, band_number, key, domain, value);
+                        return get_metadata_item(token, dataset, attempts, band_number, key, domain, value, nanos);
                 } else { // Return other error code
                         return retval;
                 }
@@ -540,8 +696,77 @@ public class GDALWarp {
          * @return The number of attempts made (upon success) or a negative error code
          *         (upon failure)
          */
-        public static native int get_band_min_max(long token, int dataset, int attempts, /* */
-                        int band, boolean approx_okay, double[] minmax, int[] success);
+        public static int get_band_min_max(long token, int dataset, int attempts, /* */
+                        int band, boolean approx_okay, double[] minmax, int[] success) {
+                return _get_band_min_max(token, dataset, attempts, band, approx_okay, minmax, success, 0);
+        }
+
+        /**
+         * Like get_band_min_max, but with a deadline for the whole scan.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded
+         * @see #get_band_min_max(long, int, int, int, boolean, double[], int[])
+         */
+        public static int get_band_min_max(long token, int dataset, int attempts, /* */
+                        int band, boolean approx_okay, double[] minmax, int[] success, long nanos) {
+                return _get_band_min_max(token, dataset, attempts, band, approx_okay, minmax, success, nanos);
+        }
+
+        private static native int _get_band_min_max(long token, int dataset, int attempts, /* */
+                        int band, boolean approx_okay, double[] minmax, int[] success, long nanos);
+
+        /**
+         * Compute statistics over the valid (not NODATA, not NaN) pixels of a band in
+         * one native pass.
+         *
+         * @param token             A token associated with some uri, options pair
+         * @param dataset           0 (or GDALWarp::SOURCE) for the source dataset, 1
+         *                          (or GDALWarp::WARPED) for the warped dataset
+         * @param attempts          The number of attempts to make before giving up
+         * @param band_number       The band number of interest
+         * @param approx_ok         Whether the statistics may be computed from an
+         *                          overview (or a sample of blocks, if there is no
+         *                          large enough overview) rather than from every
+         *                          pixel
+         * @param percentiles       The percentiles wanted, from 0 to 100 (may be
+         *                          null)
+         * @param percentile_values The return-location of the (approximate)
+         *                          percentiles
+         * @param statistics        The return-location of the valid-pixel count,
+         *                          minimum, maximum, mean and population standard
+         *                          deviation, in that order (NaN if there are no
+         *                          valid pixels)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_statistics(long token, int dataset, int attempts, /* */
+                        int band_number, boolean approx_ok, double[] percentiles, /* */
+                        double[] percentile_values, double[] statistics) {
+                return _get_statistics(token, dataset, attempts, band_number, approx_ok, percentiles,
+                                percentile_values, statistics, 0);
+        }
+
+        /**
+         * Like get_statistics, but with a deadline for the whole scan.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded
+         * @see #get_statistics(long, int, int, int, boolean, double[], double[],
+         *      double[])
+         */
+        public static int get_statistics(long token, int dataset, int attempts, /* */
+                        int band_number, boolean approx_ok, double[] percentiles, /* */
+                        double[] percentile_values, double[] statistics, long nanos) {
+                return _get_statistics(token, dataset, attempts, band_number, approx_ok, percentiles,
+                                percentile_values, statistics, nanos);
+        }
+
+        private static native int _get_statistics(long token, int dataset, int attempts, /* */
+                        int band_number, boolean approx_ok, double[] percentiles, /* */
+                        double[] percentile_values, double[] statistics, long nanos);
 
         /**
          * Get the data type of a given band.
@@ -587,6 +812,17 @@ public class GDALWarp {
         public static native int get_width_height(long token, int dataset, int attempts, /* */
                         int[] width_height);
 
+        private static native int _get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int band_number, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos);
+
         /**
          * Get pixel data.
          *
@@ -605,7 +841,7 @@ public class GDALWarp {
          * @return The number of attempts made (upon success) or a negative error code
          *         (upon failure)
          */
-        public static native int get_data( /* */
+        public static int get_data( /* */
                         long token, /* */
                         int dataset, /* */
                         int attempts, /* */
@@ -613,20 +849,1275 @@ public class GDALWarp {
                         int[] dst_window, /* */
                         int band_number, /* */
                         int type, /* */
-                        byte[] data);
+                        byte[] data) {
+                return _get_data(token, dataset, attempts, src_window, dst_window, band_number, type, data, 0);
+        }
 
         /**
-         * Get the the transform.
+         * Like get_data (for one band), but with a deadline.
          *
-         * @param token     A token associated with some uri, options pair
-         * @param dataset   0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
-         *                  GDALWarp::WARPED) for the warped dataset
-         * @param attempts  The number of attempts to make before giving up
-         * @param transform The return location for the six double-precision floating
-         *                  point number that will be returned
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int band_number, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos) {
+                return _get_data(token, dataset, attempts, src_window, dst_window, band_number, type, data, nanos);
+        }
+
+        private static native int _get_data_ex( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int offset, /* */
+                        long pixel_space, /* */
+                        long line_space, /* */
+                        long band_space, /* */
+                        int overview, /* */
+                        int resampling, /* */
+                        double[] fractional_window, /* */
+                        byte[] mask, /* */
+                        boolean mask_packed, /* */
+                        long nanos);
+
+        /**
+         * Get pixel data from several bands in one call (the warp, if any, is
+         * performed once for all of the bands).
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window Please see
+         *                   https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param dst_window Please see
+         *                   https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param band_list  The bands of interest
+         * @param interleave The layout of the returned data (one of
+         *                   GDALWarp::INTERLEAVE_BAND, GDALWarp::INTERLEAVE_PIXEL,
+         *                   or GDALWarp::INTERLEAVE_LINE)
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The return-location of the read data (must hold at least
+         *                   dst_window[0] * dst_window[1] * band_list.length pixels)
          * @return The number of attempts made (upon success) or a negative error code
          *         (upon failure)
          */
-        public static native int get_transform(long token, int dataset, int attempts, /* */
-                        double[] transform);
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        byte[] data) {
+                return _get_data_ex(token, dataset, attempts, src_window, dst_window, band_list, interleave, type, data,
+                                0, 0, 0, 0, -1, GRIORA_NearestNeighbour, null, null, false, 0);
+        }
+
+        /**
+         * Like get_data (for several bands), but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data(long, int, int, int[], int[], int[], int, int, byte[])
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos) {
+                return _get_data_ex(token, dataset, attempts, src_window, dst_window, band_list, interleave, type, data,
+                                0, 0, 0, 0, -1, GRIORA_NearestNeighbour, null, null, false, nanos);
+        }
+
+        /**
+         * Get pixel data from several bands into an arbitrary region of a
+         * caller-managed array (for example one tile of a larger mosaic, the interior
+         * of a padded buffer, or one channel of an interleaved image).
+         *
+         * The element at pixel x, line y of the b-th requested band is written at
+         * offset + x * pixel_space + y * line_space + b * band_space. A spacing of
+         * zero means "use the band-sequential default". Requests that would write
+         * outside of the array fail with -CPLE_IllegalArg.
+         *
+         * @param token       A token associated with some uri, options pair
+         * @param dataset     0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                    GDALWarp::WARPED) for the warped dataset
+         * @param attempts    The number of attempts to make before giving up
+         * @param src_window  Please see
+         *                    https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param dst_window  Please see
+         *                    https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param band_list   The bands of interest
+         * @param type        The desired type of returned pixels (the argument is of
+         *                    integral type GDALDataType)
+         * @param data        The return-location of the read data
+         * @param offset      The offset (in bytes) of the first element
+         * @param pixel_space The number of bytes between adjacent pixels
+         * @param line_space  The number of bytes between adjacent lines
+         * @param band_space  The number of bytes between adjacent bands
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int offset, /* */
+                        long pixel_space, /* */
+                        long line_space, /* */
+                        long band_space) {
+                return get_data(token, dataset, attempts, src_window, dst_window, band_list, type, data, offset,
+                                pixel_space, line_space, band_space, 0L);
+        }
+
+        /**
+         * Like get_data (into a region of an array), but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data(long, int, int, int[], int[], int[], int, byte[], int, long,
+         *      long, long)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int offset, /* */
+                        long pixel_space, /* */
+                        long line_space, /* */
+                        long band_space, /* */
+                        long nanos) {
+                return _get_data_ex(token, dataset, attempts, src_window, dst_window, band_list, INTERLEAVE_BAND, type,
+                                data, offset, pixel_space, line_space, band_space, -1, GRIORA_NearestNeighbour,
+                                null, null, false, nanos);
+        }
+
+        /**
+         * Get pixel data from an explicit overview level rather than letting GDAL
+         * choose one from the ratio of the source and destination windows.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The window to read, in the pixel space of the overview
+         *                   (see get_overview_widths_heights)
+         * @param dst_window The width and height of the returned data
+         * @param band_list  The bands of interest
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The return-location of the read data (band-sequential)
+         * @param overview   The index of the overview (-1 for full resolution)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int overview) {
+                return get_data(token, dataset, attempts, src_window, dst_window, band_list, type, data, overview, 0L);
+        }
+
+        /**
+         * Like get_data (from an overview), but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data(long, int, int, int[], int[], int[], int, byte[], int)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int overview, /* */
+                        long nanos) {
+                return _get_data_ex(token, dataset, attempts, src_window, dst_window, band_list, INTERLEAVE_BAND, type,
+                                data, 0, 0, 0, 0, overview, GRIORA_NearestNeighbour, null, null, false, nanos);
+        }
+
+        /**
+         * Get pixel data from a fractional source window with the given resampling
+         * algorithm. This lets one token serve every output resolution: the source
+         * window need not fall on pixel boundaries, and downsampled reads can average
+         * instead of taking the nearest pixel.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The x offset, y offset, width and height of the source
+         *                   window in (fractional) pixels
+         * @param dst_window The width and height of the returned data
+         * @param band_list  The bands of interest
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The return-location of the read data (band-sequential)
+         * @param resampling One of the GRIORA_* values
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        double[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int resampling) {
+                return get_data(token, dataset, attempts, src_window, dst_window, band_list, type, data, resampling,
+                                0L);
+        }
+
+        /**
+         * Like get_data (from a fractional window), but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data(long, int, int, double[], int[], int[], int, byte[], int)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        double[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        int resampling, /* */
+                        long nanos) {
+                int x = (int) Math.floor(src_window[0]);
+                int y = (int) Math.floor(src_window[1]);
+                int[] enclosing_window = new int[] { /* */
+                                x, y, /* */
+                                Math.max((int) Math.ceil(src_window[0] + src_window[2]) - x, 1), /* */
+                                Math.max((int) Math.ceil(src_window[1] + src_window[3]) - y, 1)};
+                return _get_data_ex(token, dataset, attempts, enclosing_window, dst_window, band_list, INTERLEAVE_BAND,
+                                type, data, 0, 0, 0, 0, -1, resampling, src_window, null, false, nanos);
+        }
+
+        /**
+         * Get pixel data from several bands together with the validity mask of the
+         * first of them. The mask is read under the same lock as the pixels, so the
+         * two always agree, and the mask is resampled with nearest neighbour. A
+         * non-zero mask entry means that the pixel is valid.
+         *
+         * @param token       A token associated with some uri, options pair
+         * @param dataset     0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                    GDALWarp::WARPED) for the warped dataset
+         * @param attempts    The number of attempts to make before giving up
+         * @param src_window  Please see
+         *                    https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param dst_window  Please see
+         *                    https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param band_list   The bands of interest
+         * @param type        The desired type of returned pixels (the argument is of
+         *                    integral type GDALDataType)
+         * @param data        The return-location of the read data (band-sequential)
+         * @param mask        The return-location of the mask (must hold at least
+         *                    dst_window[0] * dst_window[1] bytes, or one eighth of
+         *                    that, rounded up, if packed)
+         * @param mask_packed Whether to pack the mask into one bit per pixel (pixel i
+         *                    in row-major order is bit i % 8 of byte i / 8, as in an
+         *                    Arrow validity bitmap)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        byte[] mask, /* */
+                        boolean mask_packed) {
+                return get_data(token, dataset, attempts, src_window, dst_window, band_list, type, data, mask,
+                                mask_packed, 0L);
+        }
+
+        /**
+         * Like get_data (with a validity mask), but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data(long, int, int, int[], int[], int[], int, byte[], byte[],
+         *      boolean)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        byte[] mask, /* */
+                        boolean mask_packed, /* */
+                        long nanos) {
+                return _get_data_ex(token, dataset, attempts, src_window, dst_window, band_list, INTERLEAVE_BAND, type,
+                                data, 0, 0, 0, 0, -1, GRIORA_NearestNeighbour, null, mask, mask_packed, nanos);
+        }
+
+        private static native int _get_data_direct( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        ByteBuffer data, /* */
+                        int offset, /* */
+                        long nanos);
+
+        /**
+         * Get pixel data from one band straight into a direct buffer, without
+         * copying through the Java heap. The data are written at the position of
+         * the buffer in native byte order (use data.order(ByteOrder.nativeOrder())
+         * to read them); the position itself is not changed.
+         *
+         * @param token       A token associated with some uri, options pair
+         * @param dataset     0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                    GDALWarp::WARPED) for the warped dataset
+         * @param attempts    The number of attempts to make before giving up
+         * @param src_window  The source window (as in get_data)
+         * @param dst_window  The destination size (as in get_data)
+         * @param band_number The band of interest
+         * @param type        The desired type of returned pixels (the argument is of
+         *                    integral type GDALDataType)
+         * @param data        The (direct) return-location of the read data
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int band_number, /* */
+                        int type, /* */
+                        ByteBuffer data) {
+                return _get_data_direct(token, dataset, attempts, src_window, dst_window, new int[] { band_number },
+                                INTERLEAVE_BAND, type, data, data.position(), 0);
+        }
+
+        /**
+         * Get pixel data from several bands straight into a direct buffer (see
+         * the one-band overload).
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in get_data)
+         * @param dst_window The destination size (as in get_data)
+         * @param band_list  The bands of interest
+         * @param interleave One of the INTERLEAVE_* layouts
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The (direct) return-location of the read data
+         * @param nanos      The time budget of the call in nanoseconds (zero to limit
+         *                   only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        ByteBuffer data, /* */
+                        long nanos) {
+                return _get_data_direct(token, dataset, attempts, src_window, dst_window, band_list, interleave, type,
+                                data, data.position(), nanos);
+        }
+
+        private static native int _get_data_short( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        short[] data, /* */
+                        long nanos);
+
+        private static native int _get_data_int( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        int[] data, /* */
+                        long nanos);
+
+        private static native int _get_data_float( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        float[] data, /* */
+                        long nanos);
+
+        private static native int _get_data_double( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        double[] data, /* */
+                        long nanos);
+
+        /**
+         * Get pixel data from several bands, band-sequentially, straight into a
+         * short[] as GDT_Int16 values. GDAL writes the values into the array that
+         * will be used, so there is no byte[] to copy from and no byte swap.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in get_data)
+         * @param dst_window The destination size (as in get_data)
+         * @param band_list  The bands of interest
+         * @param data       The return-location of the read data
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        short[] data) {
+                return _get_data_short(token, dataset, attempts, src_window, dst_window, band_list, GDT_Int16, data, 0);
+        }
+
+        /**
+         * Like get_data (into a short[]), but with an explicit GDAL buffer type,
+         * which may also be GDT_UInt16 or GDT_CInt16 (read unsigned values back with & 0xffff), and a deadline.
+         *
+         * @param type  The GDAL buffer type, whose elements (or components) must
+         *              have the size of a short
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @see #get_data(long, int, int, int[], int[], int[], short[])
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        short[] data, /* */
+                        long nanos) {
+                return _get_data_short(token, dataset, attempts, src_window, dst_window, band_list, type, data, nanos);
+        }
+
+        /**
+         * Get pixel data from several bands, band-sequentially, straight into a
+         * int[] as GDT_Int32 values. GDAL writes the values into the array that
+         * will be used, so there is no byte[] to copy from and no byte swap.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in get_data)
+         * @param dst_window The destination size (as in get_data)
+         * @param band_list  The bands of interest
+         * @param data       The return-location of the read data
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int[] data) {
+                return _get_data_int(token, dataset, attempts, src_window, dst_window, band_list, GDT_Int32, data, 0);
+        }
+
+        /**
+         * Like get_data (into a int[]), but with an explicit GDAL buffer type,
+         * which may also be GDT_UInt32 or GDT_CInt32, and a deadline.
+         *
+         * @param type  The GDAL buffer type, whose elements (or components) must
+         *              have the size of a int
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @see #get_data(long, int, int, int[], int[], int[], int[])
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        int[] data, /* */
+                        long nanos) {
+                return _get_data_int(token, dataset, attempts, src_window, dst_window, band_list, type, data, nanos);
+        }
+
+        /**
+         * Get pixel data from several bands, band-sequentially, straight into a
+         * float[] as GDT_Float32 values. GDAL writes the values into the array that
+         * will be used, so there is no byte[] to copy from and no byte swap.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in get_data)
+         * @param dst_window The destination size (as in get_data)
+         * @param band_list  The bands of interest
+         * @param data       The return-location of the read data
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        float[] data) {
+                return _get_data_float(token, dataset, attempts, src_window, dst_window, band_list, GDT_Float32, data, 0);
+        }
+
+        /**
+         * Like get_data (into a float[]), but with an explicit GDAL buffer type,
+         * which may also be GDT_CFloat32, and a deadline.
+         *
+         * @param type  The GDAL buffer type, whose elements (or components) must
+         *              have the size of a float
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @see #get_data(long, int, int, int[], int[], int[], float[])
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        float[] data, /* */
+                        long nanos) {
+                return _get_data_float(token, dataset, attempts, src_window, dst_window, band_list, type, data, nanos);
+        }
+
+        /**
+         * Get pixel data from several bands, band-sequentially, straight into a
+         * double[] as GDT_Float64 values. GDAL writes the values into the array that
+         * will be used, so there is no byte[] to copy from and no byte swap.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in get_data)
+         * @param dst_window The destination size (as in get_data)
+         * @param band_list  The bands of interest
+         * @param data       The return-location of the read data
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        double[] data) {
+                return _get_data_double(token, dataset, attempts, src_window, dst_window, band_list, GDT_Float64, data, 0);
+        }
+
+        /**
+         * Like get_data (into a double[]), but with an explicit GDAL buffer type,
+         * which may also be GDT_CFloat64, and a deadline.
+         *
+         * @param type  The GDAL buffer type, whose elements (or components) must
+         *              have the size of a double
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @see #get_data(long, int, int, int[], int[], int[], double[])
+         */
+        public static int get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        double[] data, /* */
+                        long nanos) {
+                return _get_data_double(token, dataset, attempts, src_window, dst_window, band_list, type, data, nanos);
+        }
+
+        private static native ByteBuffer _acquire_buffer(long size);
+
+        /**
+         * Check out a page-aligned direct buffer (in native byte order) from the
+         * native pool of reusable read buffers, for use with the ByteBuffer
+         * overloads of get_data. The buffer may be used for any number of reads;
+         * reads into buffers taken from a warm pool allocate no memory on either
+         * side of the JNI boundary. The pool keeps up to GDALWARP_BUFFER_POOL_BYTES
+         * idle bytes, backed by huge pages if GDALWARP_BUFFER_POOL_HUGEPAGES is set.
+         *
+         * @param size The minimum size of the buffer in bytes (the capacity of the
+         *             buffer is the next power of two)
+         * @return The buffer, or null if it could not be allocated
+         */
+        public static ByteBuffer acquire_buffer(int size) {
+                ByteBuffer buffer = _acquire_buffer(size);
+                return (buffer != null) ? buffer.order(ByteOrder.nativeOrder()) : null;
+        }
+
+        /**
+         * Return a buffer to the native pool. Neither the buffer nor any view of it
+         * may be used afterward.
+         *
+         * @param buffer A buffer returned by acquire_buffer
+         * @return 1 (upon success) or a negative error code (upon failure)
+         */
+        public static native int release_buffer(ByteBuffer buffer);
+
+        private static native int _get_data_arrow( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        boolean validity, /* */
+                        long array_address, /* */
+                        long schema_address, /* */
+                        long nanos);
+
+        /**
+         * Get pixel data as an Arrow struct array with one column per band and one
+         * row per pixel, through the Arrow C Data Interface. The ArrowArray and
+         * ArrowSchema structures are written at the given addresses (for example
+         * those of org.apache.arrow.c.ArrowArray.allocateNew(allocator) and
+         * ArrowSchema.allocateNew(allocator)), and Data.importVectorSchemaRoot can
+         * then import the natively allocated columns without copying.
+         *
+         * @param token          A token associated with some uri, options pair
+         * @param dataset        0 (or GDALWarp::SOURCE) for the source dataset, 1
+         *                       (or GDALWarp::WARPED) for the warped dataset
+         * @param attempts       The number of attempts to make before giving up
+         * @param src_window     The source window (as in get_data)
+         * @param dst_window     The destination size (as in get_data)
+         * @param band_list      The bands of interest (null for all bands)
+         * @param type           The desired type of returned pixels (a non-complex
+         *                       GDALDataType)
+         * @param validity       Whether to export validity bitmaps built from the
+         *                       masks (NODATA) of the bands
+         * @param array_address  The address of an ArrowArray structure
+         * @param schema_address The address of an ArrowSchema structure
+         * @param nanos          The time budget of the call in nanoseconds (zero to limit
+         *                       only the retries, to GDALWARP_DEFAULT_NANOS)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data_arrow( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        boolean validity, /* */
+                        long array_address, /* */
+                        long schema_address, /* */
+                        long nanos) {
+                return _get_data_arrow(token, dataset, attempts, src_window, dst_window, band_list, type, validity,
+                                array_address, schema_address, nanos);
+        }
+
+        private static native int _get_data_batch( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_windows, /* */
+                        int[] dst_windows, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        byte[][] data, /* */
+                        long nanos);
+
+        /**
+         * Get pixel data from many windows of one dataset in one call. The token is
+         * resolved and a dataset is locked once for the whole batch, and the windows
+         * are read in source block order (the results are returned in the order in
+         * which the windows were given).
+         *
+         * @param token       A token associated with some uri, options pair
+         * @param dataset     0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                    GDALWarp::WARPED) for the warped dataset
+         * @param attempts    The number of attempts to make before giving up
+         * @param src_windows The source windows (each as in get_data)
+         * @param dst_windows The destination sizes (each as in get_data)
+         * @param band_list   The bands of interest
+         * @param type        The desired type of returned pixels (the argument is of
+         *                    integral type GDALDataType)
+         * @param data        The return-locations of the read data (one per window,
+         *                    each band-sequential)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_data_batch( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[][] src_windows, /* */
+                        int[][] dst_windows, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[][] data) {
+                return get_data_batch(token, dataset, attempts, src_windows, dst_windows, band_list, type, data, 0);
+        }
+
+        /**
+         * Like get_data_batch, but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_data_batch
+         */
+        public static int get_data_batch( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[][] src_windows, /* */
+                        int[][] dst_windows, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[][] data, /* */
+                        long nanos) {
+                int count = data.length;
+                if (src_windows.length != count || dst_windows.length != count) {
+                        throw new IllegalArgumentException("one source and one destination window per buffer");
+                }
+                int[] flat_src_windows = new int[4 * count];
+                int[] flat_dst_windows = new int[2 * count];
+                for (int i = 0; i < count; ++i) {
+                        System.arraycopy(src_windows[i], 0, flat_src_windows, 4 * i, 4);
+                        System.arraycopy(dst_windows[i], 0, flat_dst_windows, 2 * i, 2);
+                }
+                return _get_data_batch(token, dataset, attempts, flat_src_windows, flat_dst_windows, band_list,
+                                INTERLEAVE_BAND, type, data, nanos);
+        }
+
+        private static native int _get_mosaic( /* */
+                        long[] tokens, /* */
+                        int attempts, /* */
+                        double[] dst_extent, /* */
+                        int[] dst_size, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos);
+
+        /**
+         * Composite the warped datasets of several tokens into one buffer, so that a
+         * tile spanning several scenes can be built in one call. Where the scenes
+         * overlap, the first valid pixel (in token order) wins; validity is
+         * determined by the mask of the first requested band only (which honors its
+         * NODATA value in the source type). The warped datasets must share the CRS of the
+         * destination extent and have north-up transforms.
+         *
+         * Pixels that no token covers keep their initial value.
+         *
+         * @param tokens     The tokens, in priority order
+         * @param attempts   The number of attempts to make (per token) before giving
+         *                   up
+         * @param dst_extent The minimum x, minimum y, maximum x and maximum y of the
+         *                   destination
+         * @param dst_size   The width and height of the destination
+         * @param band_list  The bands of interest
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The return-location of the composited data
+         *                   (band-sequential)
+         * @return The total number of attempts made (upon success, zero if no token
+         *         overlaps the extent) or a negative error code (upon failure)
+         */
+        public static int get_mosaic( /* */
+                        long[] tokens, /* */
+                        int attempts, /* */
+                        double[] dst_extent, /* */
+                        int[] dst_size, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data) {
+                return _get_mosaic(tokens, attempts, dst_extent, dst_size, band_list, type, data, 0);
+        }
+
+        /**
+         * Like get_mosaic, but with a deadline for each read.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_mosaic
+         */
+        public static int get_mosaic( /* */
+                        long[] tokens, /* */
+                        int attempts, /* */
+                        double[] dst_extent, /* */
+                        int[] dst_size, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos) {
+                return _get_mosaic(tokens, attempts, dst_extent, dst_size, band_list, type, data, nanos);
+        }
+
+        /**
+         * Announce that a window is about to be read so that remote range fetches can
+         * overlap with other work. This returns immediately; in the background, the
+         * first idle copy of the dataset passes the hint to GDAL (AdviseRead) and, if
+         * warm is true, reads the window once to fill the caches. If every copy is
+         * busy, the prefetch is dropped.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param src_window The window that will be read (as in get_data)
+         * @param band_list  The bands that will be read (null for all bands)
+         * @param warm       Whether to read the window in the background
+         * @return 1 if the prefetch was queued or a negative error code (upon
+         *         failure)
+         */
+        public static int prefetch( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int[] src_window, /* */
+                        int[] band_list, /* */
+                        boolean warm) {
+                return _prefetch(token, dataset, 1, src_window, band_list, warm, 0);
+        }
+
+        /**
+         * Like prefetch, but retrying while every copy is busy and with a time budget.
+         *
+         * @param attempts The number of passes over the copies of the dataset to make
+         *                 before the prefetch is dropped
+         * @param nanos    The time budget of the prefetch in nanoseconds, counted from
+         *                 when it starts in the background (zero to limit only the
+         *                 retries, to GDALWARP_DEFAULT_NANOS)
+         * @see #prefetch(long, int, int[], int[], boolean)
+         */
+        public static int prefetch( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] band_list, /* */
+                        boolean warm, /* */
+                        long nanos) {
+                return _prefetch(token, dataset, attempts, src_window, band_list, warm, nanos);
+        }
+
+        private static native int _prefetch( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] band_list, /* */
+                        boolean warm, /* */
+                        long nanos);
+
+        private static native long _submit_get_data( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        ByteBuffer data, /* */
+                        long nanos);
+
+        private static native int _poll_completions(long[] ids, int[] results, long wait_nanos);
+
+        /**
+         * Read pixel data in the background. The read runs on the native worker
+         * pool (see GDALWARP_NUM_THREADS) and the returned future is completed, from
+         * a daemon thread that polls the native completion queue, with what get_data
+         * would have returned. Reads still outstanding when deinit is called complete
+         * with -CPLE_UserInterrupt.
+         *
+         * The data are written into a direct buffer, in native byte order (use
+         * data.order(ByteOrder.nativeOrder()) to read them); the buffer must not be
+         * touched until the future is complete.
+         *
+         * @param token      A token associated with some uri, options pair
+         * @param dataset    0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                   GDALWarp::WARPED) for the warped dataset
+         * @param attempts   The number of attempts to make before giving up
+         * @param src_window The source window (as in get_data)
+         * @param dst_window The destination size (as in get_data)
+         * @param band_list  The bands of interest
+         * @param interleave One of the INTERLEAVE_* layouts
+         * @param type       The desired type of returned pixels (the argument is of
+         *                   integral type GDALDataType)
+         * @param data       The (direct) return-location of the read data
+         * @param nanos      The time budget of the read in nanoseconds, counted from
+         *                   submission (zero to limit only the retries, to
+         *                   GDALWARP_DEFAULT_NANOS)
+         * @return A future holding the number of attempts made (upon success) or a
+         *         negative error code (upon failure)
+         */
+        public static CompletableFuture<Integer> get_data_async( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int interleave, /* */
+                        int type, /* */
+                        ByteBuffer data, /* */
+                        long nanos) {
+                CompletableFuture<Integer> future = new CompletableFuture<>();
+
+                // Registration and lookup share a lock so that a read that completes
+                // before its future is registered is not lost
+                synchronized (async_lock) {
+                        long id = _submit_get_data(token, dataset, attempts, src_window, dst_window, band_list,
+                                        interleave, type, data, nanos);
+                        if (id < 0) {
+                                future.complete((int) id);
+                                return future;
+                        }
+                        async_pending.put(id, future);
+                        if (async_poller == null) {
+                                async_poller = new Thread(GDALWarp::poll_async, "gdalwarp-completions");
+                                async_poller.setDaemon(true);
+                                async_poller.start();
+                        }
+                }
+                return future;
+        }
+
+        private static void poll_async() {
+                long[] ids = new long[64];
+                int[] results = new int[64];
+
+                while (true) {
+                        int count = _poll_completions(ids, results, 100000000L);
+                        synchronized (async_lock) {
+                                // The library has been deinitialized (deinit finishes every
+                                // outstanding read, so this leaves nothing behind natively)
+                                if (count < 0) {
+                                        for (CompletableFuture<Integer> future : async_pending.values()) {
+                                                future.complete(count);
+                                        }
+                                        async_pending.clear();
+                                        async_poller = null;
+                                        return;
+                                }
+                                for (int i = 0; i < count; ++i) {
+                                        CompletableFuture<Integer> future = async_pending.remove(ids[i]);
+                                        if (future != null) {
+                                                future.complete(results[i]);
+                                        }
+                                }
+                                if (async_pending.isEmpty()) {
+                                        async_poller = null;
+                                        return;
+                                }
+                        }
+                }
+        }
+
+        private static native int _warp_into( /* */
+                        long token, /* */
+                        int attempts, /* */
+                        String dst_srs, /* */
+                        double[] dst_transform, /* */
+                        int[] dst_size, /* */
+                        int[] band_list, /* */
+                        int resample, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos);
+
+        /**
+         * Warp the source dataset of a token onto an arbitrary target grid. No warped
+         * VRT is built and no dataset-cache slot is used, so this suits many one-off
+         * grids (web tiles in several projections, for example) better than a token
+         * per grid.
+         *
+         * @param token         A token associated with some uri, options pair
+         * @param attempts      The number of attempts to make before giving up
+         * @param dst_srs       The target CRS (for example "EPSG:3857", a PROJ string,
+         *                      or WKT)
+         * @param dst_transform The geotransform of the target grid
+         * @param dst_size      The width and height of the target grid
+         * @param band_list     The bands of interest (at least one)
+         * @param resample      One of the GRA_* values
+         * @param type          The desired type of returned pixels (the argument is
+         *                      of integral type GDALDataType)
+         * @param data          The return-location of the warped data
+         *                      (band-sequential)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int warp_into( /* */
+                        long token, /* */
+                        int attempts, /* */
+                        String dst_srs, /* */
+                        double[] dst_transform, /* */
+                        int[] dst_size, /* */
+                        int[] band_list, /* */
+                        int resample, /* */
+                        int type, /* */
+                        byte[] data) {
+                return _warp_into(token, attempts, dst_srs, dst_transform, dst_size, band_list, resample, type, data, 0);
+        }
+
+        /**
+         * Like warp_into, but with a deadline.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #warp_into
+         */
+        public static int warp_into( /* */
+                        long token, /* */
+                        int attempts, /* */
+                        String dst_srs, /* */
+                        double[] dst_transform, /* */
+                        int[] dst_size, /* */
+                        int[] band_list, /* */
+                        int resample, /* */
+                        int type, /* */
+                        byte[] data, /* */
+                        long nanos) {
+                return _warp_into(token, attempts, dst_srs, dst_transform, dst_size, band_list, resample, type, data, nanos);
+        }
+
+        private static native int _get_encoded_tile( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        String format, /* */
+                        String[] creation_options, /* */
+                        byte[][] tile, /* */
+                        long nanos);
+
+        /**
+         * Read a tile and encode it natively with a GDAL driver (for example "PNG",
+         * "JPEG" or "WEBP"). Only the encoded bytes are copied into the Java heap,
+         * and the dataset lock is released before encoding starts.
+         *
+         * @param token            A token associated with some uri, options pair
+         * @param dataset          0 (or GDALWarp::SOURCE) for the source dataset, 1
+         *                         (or GDALWarp::WARPED) for the warped dataset
+         * @param attempts         The number of attempts to make before giving up
+         * @param src_window       Please see
+         *                         https://gdal.org/api/raster_c_api.html?highlight=rasterio#_CPPv419GDALDatasetRasterIO12GDALDatasetH10GDALRWFlagiiiiPvii12GDALDataTypeiPiiii
+         * @param dst_window       The width and height of the tile
+         * @param band_list        The bands to encode (null for all bands)
+         * @param type             The type of the encoded pixels (the argument is of
+         *                         integral type GDALDataType; most encoders want
+         *                         GDT_Byte)
+         * @param format           The short name of the GDAL driver
+         * @param creation_options Driver creation options such as "QUALITY=85" (null
+         *                         for none)
+         * @param tile             The return-location of the encoded tile (tile[0]
+         *                         is set to a new array of exactly the right size)
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_encoded_tile( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        String format, /* */
+                        String[] creation_options, /* */
+                        byte[][] tile) {
+                return _get_encoded_tile(token, dataset, attempts, src_window, dst_window, band_list, type, format, creation_options, tile, 0);
+        }
+
+        /**
+         * Like get_encoded_tile, but with a deadline for the read.
+         *
+         * @param nanos The time budget of the call in nanoseconds (zero to limit
+         *              only the retries, to GDALWARP_DEFAULT_NANOS); the call
+         *              fails with -CPLE_FileIO once it is exceeded, even during a read
+         * @see #get_encoded_tile
+         */
+        public static int get_encoded_tile( /* */
+                        long token, /* */
+                        int dataset, /* */
+                        int attempts, /* */
+                        int[] src_window, /* */
+                        int[] dst_window, /* */
+                        int[] band_list, /* */
+                        int type, /* */
+                        String format, /* */
+                        String[] creation_options, /* */
+                        byte[][] tile, /* */
+                        long nanos) {
+                return _get_encoded_tile(token, dataset, attempts, src_window, dst_window, band_list, type, format, creation_options, tile, nanos);
+        }
+
+        /**
+         * Get the the transform.
+         *
+         * @param token     A token associated with some uri, options pair
+         * @param dataset   0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                  GDALWarp::WARPED) for the warped dataset
+         * @param attempts  The number of attempts to make before giving up
+         * @param transform The return location for the six double-precision floating
+         *                  point number that will be returned
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static native int get_transform(long token, int dataset, int attempts, /* */
+                        double[] transform);
+
+        private static native int _get_info(long token, int dataset, int attempts, /* */
+                        byte[] info);
+
+        /**
+         * Get all of the immutable properties of a dataset (dimensions, transform,
+         * CRS, and per-band types, NODATA values, offsets, scales, block sizes and
+         * overview sizes) in one call.
+         *
+         * The returned buffer is in native byte order. It begins with a header of
+         * INFO_HEADER_SIZE bytes (fields at the INFO_* offsets), followed by one
+         * record per band of INFO_BAND_SIZE bytes (fields at the INFO_BAND_*
+         * offsets) each of which is followed by its overview widths and heights as
+         * int pairs (padded to a multiple of eight bytes), followed by the
+         * NUL-terminated WKT of the CRS.
+         *
+         * @param token    A token associated with some uri, options pair
+         * @param dataset  0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                 GDALWarp::WARPED) for the warped dataset
+         * @param attempts The number of attempts to make before giving up
+         * @param info     The return-location of the record
+         * @return The number of attempts made (upon success) or a negative error code
+         *         (upon failure)
+         */
+        public static int get_info(long token, int dataset, int attempts, ByteBuffer[] info) {
+                ensure_scratch_1d();
+                int retval = _get_info(token, dataset, attempts, scratch_1d.get());
+
+                if (retval >= 0) {
+                        byte[] bytes = scratch_1d.get();
+                        int size = ByteBuffer.wrap(bytes).order(ByteOrder.nativeOrder()).getInt(INFO_SIZE);
+                        info[0] = ByteBuffer.wrap(Arrays.copyOf(bytes, size)).order(ByteOrder.nativeOrder());
+                        return retval;
+                } else if (retval == -1) { // CPLE_AppDefined means array too small
+                        int size = ByteBuffer.wrap(scratch_1d.get()).order(ByteOrder.nativeOrder()).getInt(INFO_SIZE);
+                        grow_scratch_1d(size);
+                        return get_info(token, dataset, attempts, info);
+                } else { // Return other error code
+                        return retval;
+                }
+        }
 }
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.azavea.gdal;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+
+/**
+ * A handle on one dataset (the source or warped dataset of a token) that
+ * fetches the immutable properties of the dataset once, through
+ * GDALWarp.get_info, and answers them from Java fields. Only pixel reads
+ * cross into native code.
+ *
+ * Band numbers start at one, as in GDALWarp.
+ */
+public class GDALWarpDataset {
+        private final long token;
+        private final int dataset;
+        private final int attempts;
+
+        private final int width;
+        private final int height;
+        private final int band_count;
+        private final double[] transform;
+        private final String crs_wkt;
+
+        private final int[] data_type;
+        private final int[] color_interp;
+        private final int[] block_width;
+        private final int[] block_height;
+        private final boolean[] has_nodata;
+        private final boolean[] has_offset;
+        private final boolean[] has_scale;
+        private final double[] nodata;
+        private final double[] offset;
+        private final double[] scale;
+        private final int[][] overview_widths;
+        private final int[][] overview_heights;
+
+        /**
+         * Fetch the properties of a dataset.
+         *
+         * @param token    A token associated with some uri, options pair
+         * @param dataset  0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                 GDALWarp::WARPED) for the warped dataset
+         * @param attempts The number of attempts to make before giving up (here
+         *                 and in every read)
+         * @throws IOException If the properties could not be fetched
+         */
+        public GDALWarpDataset(long token, int dataset, int attempts) throws IOException {
+                ByteBuffer[] info = new ByteBuffer[1];
+                int retval = GDALWarp.get_info(token, dataset, attempts, info);
+                if (retval < 0) {
+                        throw new IOException("get_info failed with error code " + retval);
+                }
+                ByteBuffer buffer = info[0];
+
+                this.token = token;
+                this.dataset = dataset;
+                this.attempts = attempts;
+
+                this.width = buffer.getInt(GDALWarp.INFO_WIDTH);
+                this.height = buffer.getInt(GDALWarp.INFO_HEIGHT);
+                this.band_count = buffer.getInt(GDALWarp.INFO_BAND_COUNT);
+                this.transform = new double[6];
+                for (int i = 0; i < 6; ++i) {
+                        this.transform[i] = buffer.getDouble(GDALWarp.INFO_TRANSFORM + 8 * i);
+                }
+
+                this.data_type = new int[band_count];
+                this.color_interp = new int[band_count];
+                this.block_width = new int[band_count];
+                this.block_height = new int[band_count];
+                this.has_nodata = new boolean[band_count];
+                this.has_offset = new boolean[band_count];
+                this.has_scale = new boolean[band_count];
+                this.nodata = new double[band_count];
+                this.offset = new double[band_count];
+                this.scale = new double[band_count];
+                this.overview_widths = new int[band_count][];
+                this.overview_heights = new int[band_count][];
+
+                // Each band record is followed by its overview sizes
+                int record = GDALWarp.INFO_HEADER_SIZE;
+                for (int b = 0; b < band_count; ++b) {
+                        data_type[b] = buffer.getInt(record + GDALWarp.INFO_BAND_DATA_TYPE);
+                        color_interp[b] = buffer.getInt(record + GDALWarp.INFO_BAND_COLOR_INTERP);
+                        block_width[b] = buffer.getInt(record + GDALWarp.INFO_BAND_BLOCK_WIDTH);
+                        block_height[b] = buffer.getInt(record + GDALWarp.INFO_BAND_BLOCK_HEIGHT);
+                        has_nodata[b] = buffer.getInt(record + GDALWarp.INFO_BAND_HAS_NODATA) != 0;
+                        has_offset[b] = buffer.getInt(record + GDALWarp.INFO_BAND_HAS_OFFSET) != 0;
+                        has_scale[b] = buffer.getInt(record + GDALWarp.INFO_BAND_HAS_SCALE) != 0;
+                        nodata[b] = buffer.getDouble(record + GDALWarp.INFO_BAND_NODATA);
+                        offset[b] = buffer.getDouble(record + GDALWarp.INFO_BAND_OFFSET);
+                        scale[b] = buffer.getDouble(record + GDALWarp.INFO_BAND_SCALE);
+
+                        int overview_count = buffer.getInt(record + GDALWarp.INFO_BAND_OVERVIEW_COUNT);
+                        overview_widths[b] = new int[overview_count];
+                        overview_heights[b] = new int[overview_count];
+                        record += GDALWarp.INFO_BAND_SIZE;
+                        for (int i = 0; i < overview_count; ++i) {
+                                overview_widths[b][i] = buffer.getInt(record + 8 * i);
+                                overview_heights[b][i] = buffer.getInt(record + 8 * i + 4);
+                        }
+                        record += 8 * overview_count;
+                }
+
+                byte[] wkt = new byte[buffer.getInt(GDALWarp.INFO_CRS_WKT_LENGTH)];
+                for (int i = 0; i < wkt.length; ++i) {
+                        wkt[i] = buffer.get(record + i);
+                }
+                this.crs_wkt = new String(wkt, StandardCharsets.UTF_8);
+        }
+
+        /**
+         * Fetch the properties of the dataset of a new token.
+         *
+         * @param uri      A string containing the URI
+         * @param options  An array of strings contains the warp options
+         * @param dataset  0 (or GDALWarp::SOURCE) for the source dataset, 1 (or
+         *                 GDALWarp::WARPED) for the warped dataset
+         * @param attempts The number of attempts to make before giving up
+         * @throws IOException If the properties could not be fetched
+         */
+        public GDALWarpDataset(String uri, String[] options, int dataset, int attempts) throws IOException {
+                this(GDALWarp.get_token(uri, options), dataset, attempts);
+        }
+
+        public long get_token() {
+                return token;
+        }
+
+        public int get_dataset() {
+                return dataset;
+        }
+
+        public int get_width() {
+                return width;
+        }
+
+        public int get_height() {
+                return height;
+        }
+
+        public int get_band_count() {
+                return band_count;
+        }
+
+        /**
+         * @return A copy of the six-element affine transform
+         */
+        public double[] get_transform() {
+                return transform.clone();
+        }
+
+        public String get_crs_wkt() {
+                return crs_wkt;
+        }
+
+        public int get_data_type(int band_number) {
+                return data_type[band_number - 1];
+        }
+
+        public int get_color_interpretation(int band_number) {
+                return color_interp[band_number - 1];
+        }
+
+        public int get_block_width(int band_number) {
+                return block_width[band_number - 1];
+        }
+
+        public int get_block_height(int band_number) {
+                return block_height[band_number - 1];
+        }
+
+        public boolean has_nodata(int band_number) {
+                return has_nodata[band_number - 1];
+        }
+
+        /**
+         * @return The NODATA value of the band (meaningful only if has_nodata)
+         */
+        public double get_nodata(int band_number) {
+                return nodata[band_number - 1];
+        }
+
+        public boolean has_offset(int band_number) {
+                return has_offset[band_number - 1];
+        }
+
+        public double get_offset(int band_number) {
+                return offset[band_number - 1];
+        }
+
+        public boolean has_scale(int band_number) {
+                return has_scale[band_number - 1];
+        }
+
+        public double get_scale(int band_number) {
+                return scale[band_number - 1];
+        }
+
+        public int get_overview_count(int band_number) {
+                return overview_widths[band_number - 1].length;
+        }
+
+        public int get_overview_width(int band_number, int overview) {
+                return overview_widths[band_number - 1][overview];
+        }
+
+        public int get_overview_height(int band_number, int overview) {
+                return overview_heights[band_number - 1][overview];
+        }
+
+        /**
+         * Read one band (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int band_number, int type, byte[] data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_number, type, data);
+        }
+
+        /**
+         * Read several bands with the given interleaving (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int[] band_list, int interleave, int type,
+                        byte[] data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_list, interleave, type,
+                                data);
+        }
+
+        /**
+         * Read one band into a direct buffer (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int band_number, int type, ByteBuffer data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_number, type, data);
+        }
+
+        /**
+         * Read several bands, band-sequentially, as Int16 (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int[] band_list, short[] data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_list, data);
+        }
+
+        /**
+         * Read several bands, band-sequentially, as Int32 (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int[] band_list, int[] data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_list, data);
+        }
+
+        /**
+         * Read several bands, band-sequentially, as Float32 (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int[] band_list, float[] data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_list, data);
+        }
+
+        /**
+         * Read several bands, band-sequentially, as Float64 (see GDALWarp.get_data).
+         */
+        public int get_data(int[] src_window, int[] dst_window, int[] band_list, double[] data) {
+                return GDALWarp.get_data(token, dataset, attempts, src_window, dst_window, band_list, data);
+        }
+}
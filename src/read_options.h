@@ -0,0 +1,73 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __READ_OPTIONS_H__
+#define __READ_OPTIONS_H__
+
+#include <stdint.h>
+
+/* Output layouts for multi-band reads */
+#define INTERLEAVE_BAND (0)  /* All of band 1, then all of band 2, ... */
+#define INTERLEAVE_PIXEL (1) /* The bands of pixel 1, then of pixel 2, ... */
+#define INTERLEAVE_LINE (2)  /* The bands of line 1, then of line 2, ... */
+
+/*
+ * Optional arguments for get_data_ex, in the spirit of
+ * GDALRasterIOExtraArg.  Initialize with INIT_READ_OPTIONS before
+ * setting the fields of interest.
+ */
+typedef struct
+{
+    int band_count;              /* Number of bands to read (0 for all bands) */
+    const int *band_list;        /* Bands to read (NULL for 1 ... band_count; must be NULL when band_count is 0) */
+    int interleave;              /* One of the INTERLEAVE_* values */
+    int64_t pixel_space;         /* Bytes between pixels (0 for the layout default) */
+    int64_t line_space;          /* Bytes between lines (0 for the layout default) */
+    int64_t band_space;          /* Bytes between bands (0 for the layout default) */
+    int overview;                /* Overview to read from (-1 for full resolution) */
+    int resampling;              /* A GDALRIOResampleAlg (0 for nearest neighbour) */
+    int has_fractional_window;   /* Whether fractional_window replaces the source window */
+    double fractional_window[4]; /* Source x, y, width, height in (fractional) pixels */
+    uint8_t *mask;               /* If not NULL, the return-location of the validity mask of the first band */
+    int mask_packed;             /* Whether the mask is one bit per pixel (see MASK_BYTES) rather than one byte */
+} read_options_t;
+
+/*
+ * The size in bytes of a mask of width × height pixels.  A packed
+ * mask stores pixel i (in row-major order, with no padding between
+ * rows) in bit i % 8 of byte i / 8, as Arrow validity bitmaps do; an
+ * unpacked mask stores one byte per pixel.  Non-zero means valid.
+ */
+#define MASK_BYTES(width, height, packed) \
+    ((packed) ? ((int64_t)(width) * (height) + 7) / 8 : (int64_t)(width) * (height))
+
+#define INIT_READ_OPTIONS(s)              \
+    do                                    \
+    {                                     \
+        (s).band_count = 0;               \
+        (s).band_list = NULL;             \
+        (s).interleave = INTERLEAVE_BAND; \
+        (s).pixel_space = 0;              \
+        (s).line_space = 0;               \
+        (s).band_space = 0;               \
+        (s).overview = -1;                \
+        (s).resampling = 0;               \
+        (s).has_fractional_window = 0;    \
+        (s).mask = NULL;                  \
+        (s).mask_packed = 0;              \
+    } while (0)
+
+#endif
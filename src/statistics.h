@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STATISTICS_H__
+#define __STATISTICS_H__
+
+#include <stdint.h>
+
+/*
+ * Statistics over the valid (not NODATA, not NaN) pixels of a band,
+ * as returned by get_statistics.  When there are no valid pixels, the
+ * count is zero and the other fields are NaN.
+ */
+typedef struct
+{
+    int64_t valid_count; /* Number of valid pixels */
+    double minimum;      /* Smallest valid value */
+    double maximum;      /* Largest valid value */
+    double mean;         /* Mean of the valid values */
+    double stddev;       /* Population standard deviation of the valid values */
+} statistics_t;
+
+#endif
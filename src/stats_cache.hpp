@@ -0,0 +1,195 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STATS_CACHE_HPP__
+#define __STATS_CACHE_HPP__
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <cpl_conv.h>
+#include <cpl_string.h>
+#include <cpl_vsi.h>
+
+/*
+ * A persistent store of computed statistics (histograms, minima and
+ * maxima, ...) in a local directory, so that they survive the process
+ * and are shared by every process that uses the same directory.  It
+ * never writes next to the dataset (as PAM .aux.xml files do), so it
+ * works for read-only and remote datasets.
+ *
+ * Each entry is one file, named by a hash of its key, that records
+ * the full key and a validator of the dataset (size, modification
+ * time and, where the file system reports one, ETag) followed by the
+ * values.  An entry is only returned if both the key and the
+ * validator match, so statistics of a dataset that has changed are
+ * recomputed.  Entries are written to a temporary file and renamed
+ * into place, so concurrent readers and writers need no lock.
+ */
+class stats_cache
+{
+public:
+    /*
+     * Constructor
+     *
+     * @param directory The directory to keep entries in (created if
+     *                  necessary)
+     */
+    explicit stats_cache(const std::string &directory)
+        : m_directory(directory)
+    {
+        VSIMkdirRecursive(m_directory.c_str(), 0755);
+    }
+
+    /*
+     * Compute the validator of a dataset.
+     *
+     * @param uri The URI of the dataset
+     * @param validator The return-location of the validator
+     * @return True on success, false if the URI does not name a file
+     *         (for example, if it is a VRT document or a subdataset),
+     *         in which case its statistics should not be cached
+     */
+    static bool validator(const std::string &uri, std::string *validator)
+    {
+        auto path = uri;
+        if (path.compare(0, 7, "http://") == 0 || path.compare(0, 8, "https://") == 0)
+        {
+            path = "/vsicurl/" + path;
+        }
+
+        VSIStatBufL stat;
+        if (VSIStatExL(path.c_str(), &stat, VSI_STAT_EXISTS_FLAG | VSI_STAT_SIZE_FLAG) != 0 || VSI_ISDIR(stat.st_mode))
+        {
+            return false;
+        }
+        *validator = "size=" + std::to_string(static_cast<long long>(stat.st_size)) +
+                     " mtime=" + std::to_string(static_cast<long long>(stat.st_mtime));
+
+        char **headers = VSIGetFileMetadata(path.c_str(), "HEADERS", nullptr);
+        const char *etag = CSLFetchNameValue(headers, "ETag");
+        if (etag != nullptr)
+        {
+            *validator += std::string(" etag=") + etag;
+        }
+        CSLDestroy(headers);
+
+        return true;
+    }
+
+    /*
+     * Look up an entry.
+     *
+     * @param key The key
+     * @param validator The current validator of the dataset
+     * @param values The return-location of the values
+     * @return True if a valid entry was found
+     */
+    bool get(const std::string &key, const std::string &validator, std::vector<double> *values) const
+    {
+        auto path = filename(key);
+        VSIStatBufL stat;
+        GByte *bytes = nullptr;
+        vsi_l_offset size = 0;
+
+        if (VSIStatExL(path.c_str(), &stat, VSI_STAT_EXISTS_FLAG) != 0 ||
+            !VSIIngestFile(nullptr, path.c_str(), &bytes, &size, 1 << 24))
+        {
+            return false;
+        }
+        auto contents = std::string(reinterpret_cast<char *>(bytes), static_cast<size_t>(size));
+        VSIFree(bytes);
+
+        auto header = preamble(key, validator);
+        if (contents.compare(0, header.size(), header) != 0)
+        {
+            return false;
+        }
+
+        values->clear();
+        const char *p = contents.c_str() + header.size();
+        char *end = nullptr;
+        for (double value = CPLStrtod(p, &end); end != p; value = CPLStrtod(p, &end))
+        {
+            values->push_back(value);
+            p = end;
+        }
+        return true;
+    }
+
+    /*
+     * Store an entry, replacing any previous one with the same key.
+     *
+     * @param key The key
+     * @param validator The current validator of the dataset
+     * @param values The values
+     */
+    void put(const std::string &key, const std::string &validator, const std::vector<double> &values) const
+    {
+        auto path = filename(key);
+        auto contents = preamble(key, validator);
+        char buffer[32];
+        for (auto value : values)
+        {
+            CPLsnprintf(buffer, sizeof(buffer), "%.17g\n", value);
+            contents += buffer;
+        }
+
+        // Unique to this write among all threads and processes
+        static std::atomic<unsigned long long> serial(0);
+        auto temporary = path + "." + std::to_string(static_cast<long long>(getpid())) + "." +
+                         std::to_string(serial.fetch_add(1));
+        VSILFILE *file = VSIFOpenL(temporary.c_str(), "wb");
+        if (file == nullptr)
+        {
+            return;
+        }
+        bool written = (VSIFWriteL(contents.data(), 1, contents.size(), file) == contents.size());
+        written = (VSIFCloseL(file) == 0) && written;
+        if (!written || VSIRename(temporary.c_str(), path.c_str()) != 0)
+        {
+            VSIUnlink(temporary.c_str());
+        }
+    }
+
+private:
+    static std::string preamble(const std::string &key, const std::string &validator)
+    {
+        return "gdalwarp-stats 1\n" + key + "\n" + validator + "\n";
+    }
+
+    std::string filename(const std::string &key) const
+    {
+        // 64-bit FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : key)
+        {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "%016" PRIx64 ".stats", hash);
+        return m_directory + "/" + name;
+    }
+
+    std::string m_directory;
+};
+
+#endif
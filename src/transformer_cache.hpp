@@ -0,0 +1,301 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TRANSFORMER_CACHE_HPP__
+#define __TRANSFORMER_CACHE_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+
+#include <gdal_alg.h>
+#include <ogr_srs_api.h>
+
+/*
+ * A process-wide pool of PROJ coordinate transformations, keyed by
+ * (source CRS, destination CRS).  Creating a transformation means
+ * solving a PROJ pipeline, which costs far more than using one, so
+ * transformations are kept after use and handed out again to later
+ * requests for the same pair of CRSs.
+ *
+ * A transformation is not thread-safe, so each one is checked out
+ * for exclusive use and checked back in afterward; the cache holds
+ * as many idle transformations per pair as have ever been in use at
+ * once, up to a total of capacity.
+ */
+class transformer_cache
+{
+public:
+    /* forward (source to destination) and reverse transformations */
+    typedef std::pair<OGRCoordinateTransformationH, OGRCoordinateTransformationH> transformations_t;
+    typedef std::pair<std::string, std::string> key_t;
+
+    /*
+     * Constructor
+     *
+     * @param capacity The maximum number of idle transformation pairs
+     */
+    explicit transformer_cache(size_t capacity)
+        : m_entries(),
+          m_capacity(capacity),
+          m_idle(0),
+          m_clock(0),
+          m_lock(PTHREAD_MUTEX_INITIALIZER)
+    {
+    }
+
+    transformer_cache(const transformer_cache &rhs) = delete;
+    transformer_cache &operator=(const transformer_cache &rhs) = delete;
+
+    ~transformer_cache()
+    {
+        for (auto &entry : m_entries)
+        {
+            for (auto &transformations : entry.second.idle)
+            {
+                destroy(transformations);
+            }
+        }
+        pthread_mutex_destroy(&m_lock);
+    }
+
+    /*
+     * Obtain exclusive use of a pair of transformations, creating one
+     * if none is idle.
+     *
+     * @param src_wkt The WKT of the source CRS
+     * @param dst_wkt The WKT of the destination CRS
+     * @param transformations The return-location of the transformations
+     * @return True on success, false if the transformations could not
+     *         be created
+     */
+    bool checkout(const std::string &src_wkt, const std::string &dst_wkt, transformations_t *transformations)
+    {
+        auto key = key_t(src_wkt, dst_wkt);
+
+        pthread_mutex_lock(&m_lock);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end() && !it->second.idle.empty())
+        {
+            *transformations = it->second.idle.back();
+            it->second.idle.pop_back();
+            it->second.last_used = ++m_clock;
+            --m_idle;
+            pthread_mutex_unlock(&m_lock);
+            return true;
+        }
+        pthread_mutex_unlock(&m_lock);
+
+        // Solve the PROJ pipelines without holding the lock
+        return create(src_wkt, dst_wkt, transformations);
+    }
+
+    /*
+     * Return a pair of transformations obtained from checkout.
+     *
+     * @param src_wkt The WKT of the source CRS
+     * @param dst_wkt The WKT of the destination CRS
+     * @param transformations The transformations
+     */
+    void checkin(const std::string &src_wkt, const std::string &dst_wkt, transformations_t transformations)
+    {
+        auto key = key_t(src_wkt, dst_wkt);
+        auto evicted = std::vector<transformations_t>();
+
+        pthread_mutex_lock(&m_lock);
+        auto &entry = m_entries[key];
+        entry.idle.push_back(transformations);
+        entry.last_used = ++m_clock;
+        ++m_idle;
+        while (m_idle > m_capacity)
+        {
+            // Evict from the least-recently-used pair
+            auto victim = m_entries.end();
+            for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+            {
+                if (!it->second.idle.empty() &&
+                    (victim == m_entries.end() || it->second.last_used < victim->second.last_used))
+                {
+                    victim = it;
+                }
+            }
+            evicted.push_back(victim->second.idle.back());
+            victim->second.idle.pop_back();
+            --m_idle;
+            if (victim->second.idle.empty())
+            {
+                m_entries.erase(victim);
+            }
+        }
+        pthread_mutex_unlock(&m_lock);
+
+        for (auto &e : evicted)
+        {
+            destroy(e);
+        }
+    }
+
+    /*
+     * The number of idle transformation pairs.
+     */
+    size_t size()
+    {
+        pthread_mutex_lock(&m_lock);
+        auto retval = m_idle;
+        pthread_mutex_unlock(&m_lock);
+        return retval;
+    }
+
+private:
+    struct entry_t
+    {
+        std::vector<transformations_t> idle;
+        uint64_t last_used;
+    };
+
+    static OGRSpatialReferenceH srs(const std::string &wkt)
+    {
+        auto srs = OSRNewSpatialReference(nullptr);
+        if (OSRSetFromUserInput(srs, wkt.c_str()) != OGRERR_NONE)
+        {
+            OSRDestroySpatialReference(srs);
+            return nullptr;
+        }
+        // Easting/longitude first, as GDAL geotransforms expect
+        OSRSetAxisMappingStrategy(srs, OAMS_TRADITIONAL_GIS_ORDER);
+        return srs;
+    }
+
+    static bool create(const std::string &src_wkt, const std::string &dst_wkt, transformations_t *transformations)
+    {
+        auto src = srs(src_wkt);
+        auto dst = srs(dst_wkt);
+        OGRCoordinateTransformationH forward = nullptr;
+        OGRCoordinateTransformationH reverse = nullptr;
+
+        if (src != nullptr && dst != nullptr)
+        {
+            forward = OCTNewCoordinateTransformation(src, dst);
+            reverse = OCTNewCoordinateTransformation(dst, src);
+        }
+        if (src != nullptr)
+        {
+            OSRDestroySpatialReference(src);
+        }
+        if (dst != nullptr)
+        {
+            OSRDestroySpatialReference(dst);
+        }
+
+        *transformations = transformations_t(forward, reverse);
+        if (forward == nullptr || reverse == nullptr)
+        {
+            destroy(*transformations);
+            return false;
+        }
+        return true;
+    }
+
+    static void destroy(transformations_t &transformations)
+    {
+        if (transformations.first != nullptr)
+        {
+            OCTDestroyCoordinateTransformation(transformations.first);
+        }
+        if (transformations.second != nullptr)
+        {
+            OCTDestroyCoordinateTransformation(transformations.second);
+        }
+        transformations = transformations_t(nullptr, nullptr);
+    }
+
+    std::map<key_t, entry_t> m_entries;
+    size_t m_capacity;
+    size_t m_idle;
+    uint64_t m_clock;
+    pthread_mutex_t m_lock;
+};
+
+/*
+ * A GDAL transformer between the pixel/line grids of two
+ * georeferenced rasters, built from their geotransforms and a pair of
+ * transformations checked out of a transformer_cache.  Only the
+ * transformations depend on the CRSs, so one cached pair serves every
+ * grid in the same pair of CRSs.  Use with grid_transform.
+ */
+struct grid_transformer_t
+{
+    double src_transform[6];
+    double src_inverse[6];
+    double dst_transform[6];
+    double dst_inverse[6];
+    transformer_cache::transformations_t transformations;
+};
+
+/*
+ * Initialize a grid transformer.
+ *
+ * @param transformer The transformer to initialize
+ * @param src_transform The geotransform of the source grid
+ * @param dst_transform The geotransform of the destination grid
+ * @param transformations The transformations between the CRSs of the grids
+ * @return True on success, false if either geotransform is not invertible
+ */
+inline bool grid_transformer_init(grid_transformer_t *transformer,
+                                  const double src_transform[6],
+                                  const double dst_transform[6],
+                                  transformer_cache::transformations_t transformations)
+{
+    std::copy(src_transform, src_transform + 6, transformer->src_transform);
+    std::copy(dst_transform, dst_transform + 6, transformer->dst_transform);
+    transformer->transformations = transformations;
+    return GDALInvGeoTransform(transformer->src_transform, transformer->src_inverse) &&
+           GDALInvGeoTransform(transformer->dst_transform, transformer->dst_inverse);
+}
+
+/*
+ * The GDALTransformerFunc of a grid_transformer_t.
+ */
+inline int grid_transform(void *arg, int dst_to_src, int count,
+                          double *x, double *y, double *z, int *success)
+{
+    auto transformer = static_cast<grid_transformer_t *>(arg);
+    const double *from = dst_to_src ? transformer->dst_transform : transformer->src_transform;
+    const double *to = dst_to_src ? transformer->src_inverse : transformer->dst_inverse;
+    auto transformation = dst_to_src ? transformer->transformations.second : transformer->transformations.first;
+
+    for (int i = 0; i < count; ++i)
+    {
+        GDALApplyGeoTransform(const_cast<double *>(from), x[i], y[i], &x[i], &y[i]);
+    }
+    OCTTransformEx(transformation, count, x, y, z, success);
+    for (int i = 0; i < count; ++i)
+    {
+        if (success[i])
+        {
+            GDALApplyGeoTransform(const_cast<double *>(to), x[i], y[i], &x[i], &y[i]);
+        }
+    }
+
+    return TRUE;
+}
+
+#endif
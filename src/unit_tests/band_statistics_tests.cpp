@@ -0,0 +1,102 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Band Statistics Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "band_statistics.hpp"
+
+BOOST_AUTO_TEST_CASE(skips_nodata_and_nan)
+{
+    double pixels[] = {1, 2, 107, NAN, 5};
+    auto accumulator = band_accumulator();
+
+    accumulator.set_nodata(true, 107);
+    accumulator.add(pixels, 5);
+    BOOST_TEST(accumulator.count() == 3);
+    BOOST_TEST(accumulator.minimum() == 1);
+    BOOST_TEST(accumulator.maximum() == 5);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+    double pixels[] = {-1, 0, 0.5, 1, 3.9, 4, 10};
+    auto inside = band_accumulator(0, 4, 4, false);
+    auto clamped = band_accumulator(0, 4, 4, true);
+
+    inside.add(pixels, 7);
+    clamped.add(pixels, 7);
+    BOOST_TEST((inside.histogram() == std::vector<GUIntBig>{2, 1, 0, 1}));
+    BOOST_TEST((clamped.histogram() == std::vector<GUIntBig>{3, 1, 0, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(merge_matches_single_pass)
+{
+    double pixels[] = {3, 1, 4, 1, 5, 9, 2, 6};
+    auto whole = band_accumulator(0, 10, 5, false, true);
+    auto first = whole;
+    auto second = whole;
+
+    whole.add(pixels, 8);
+    first.add(pixels, 3);
+    second.add(pixels + 3, 5);
+    first.merge(second);
+    BOOST_TEST(first.count() == whole.count());
+    BOOST_TEST(first.minimum() == whole.minimum());
+    BOOST_TEST(first.maximum() == whole.maximum());
+    BOOST_TEST((first.histogram() == whole.histogram()));
+    BOOST_CHECK_SMALL(first.mean() - whole.mean(), 1e-12);
+    BOOST_CHECK_SMALL(first.variance() - whole.variance(), 1e-12);
+    BOOST_TEST(first.percentile(50) == whole.percentile(50));
+}
+
+BOOST_AUTO_TEST_CASE(mean_and_variance)
+{
+    double pixels[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    auto accumulator = band_accumulator();
+
+    BOOST_TEST(std::isnan(accumulator.mean()));
+    accumulator.add(pixels, 8);
+    BOOST_TEST(accumulator.mean() == 5.0);
+    BOOST_TEST(accumulator.variance() == 4.0);
+}
+
+BOOST_AUTO_TEST_CASE(percentiles)
+{
+    auto pixels = std::vector<double>();
+    for (int i = 1; i <= 100; ++i)
+    {
+        pixels.push_back(i);
+        pixels.push_back(-i);
+    }
+    auto exact = band_accumulator(0, 0, 0, false, true);
+    exact.add(pixels.data(), pixels.size());
+    BOOST_TEST(exact.percentile(0) == -100);
+    BOOST_TEST(exact.percentile(25) == -51);
+    BOOST_TEST(exact.percentile(75) == 50);
+    BOOST_TEST(exact.percentile(100) == 100);
+    BOOST_TEST(std::isnan(exact.percentile(101)));
+    BOOST_TEST(std::isnan(band_accumulator().percentile(50)));
+
+    // Large values are estimated to within a relative error of 2^-7
+    double large[] = {1000.0, 12345.6, 1e9};
+    auto approximate = band_accumulator(0, 0, 0, false, true);
+    approximate.add(large, 3);
+    BOOST_TEST(std::abs(approximate.percentile(50) - 12345.6) <= 12345.6 / 128);
+}
@@ -17,7 +17,16 @@
 #define BOOST_TEST_MODULE Bindings Unit Tests
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+#include <unistd.h>
+
 #include <cpl_error.h>
+#include <cpl_vsi.h>
+#include <ogr_srs_api.h>
 
 #include "bindings.h"
 #include "locked_dataset.hpp"
@@ -46,7 +55,7 @@ BOOST_AUTO_TEST_CASE(good_uri_noop)
 {
     init(1 << 8);
     auto token = get_token(good_uri, options);
-    auto retval = noop(token, locked_dataset::SOURCE, 0, 1);
+    auto retval = noop(token, locked_dataset::SOURCE, 0, 0, 1);
     BOOST_TEST(retval > 0);
     deinit();
 }
@@ -55,7 +64,7 @@ BOOST_AUTO_TEST_CASE(bad_uri_noop)
 {
     init(1 << 8);
     auto token = get_token(bad_uri, options);
-    auto retval = noop(token, locked_dataset::SOURCE, 0, 1);
+    auto retval = noop(token, locked_dataset::SOURCE, 0, 0, 1);
     BOOST_TEST(retval == -CPLE_OpenFailed);
     deinit();
 }
@@ -63,7 +72,7 @@ BOOST_AUTO_TEST_CASE(bad_uri_noop)
 BOOST_AUTO_TEST_CASE(bad_token_noop)
 {
     init(1 << 8);
-    auto retval = noop(93, locked_dataset::SOURCE, 0, 1);
+    auto retval = noop(93, locked_dataset::SOURCE, 0, 0, 1);
     BOOST_TEST(retval == -CPLE_OpenFailed);
     deinit();
 }
@@ -101,10 +110,10 @@ BOOST_AUTO_TEST_CASE(good_uri_finite_attempts_example)
     double nodata;
     int success;
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 42, copies, 1, &nodata, &success) > 0);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 42, 0, copies, 1, &nodata, &success) > 0);
     BOOST_TEST(success == 0);
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 42, copies, 1, &nodata, &success) > 0);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 42, 0, copies, 1, &nodata, &success) > 0);
     BOOST_TEST(success != 0);
     BOOST_TEST(nodata == 107.0);
 
@@ -119,10 +128,10 @@ BOOST_AUTO_TEST_CASE(good_uri_infinite_attempts_example)
     double nodata;
     int success;
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 0, copies, 1, &nodata, &success) > 0);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 0, 0, copies, 1, &nodata, &success) > 0);
     BOOST_TEST(success == 0);
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 0, copies, 1, &nodata, &success) > 0);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 0, 0, copies, 1, &nodata, &success) > 0);
     BOOST_TEST(success != 0);
     BOOST_TEST(nodata == 107.0);
 
@@ -137,8 +146,8 @@ BOOST_AUTO_TEST_CASE(bad_uri_finite_attempts_example)
     double nodata;
     int success;
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 3, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
-    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 4, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 3, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 4, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
 
     deinit();
 }
@@ -151,8 +160,8 @@ BOOST_AUTO_TEST_CASE(bad_uri_infinite_attempts_example)
     double nodata;
     int success;
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
-    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 0, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 0, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
 
     deinit();
 }
@@ -165,8 +174,8 @@ BOOST_AUTO_TEST_CASE(bad_token_finite_attempts_example)
     double nodata;
     int success;
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 42, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
-    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 42, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 42, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 42, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
 
     deinit();
 }
@@ -179,8 +188,679 @@ BOOST_AUTO_TEST_CASE(bad_token_infinite_attempts_example)
     double nodata;
     int success;
 
-    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
-    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::SOURCE, 0, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+    BOOST_TEST(get_band_nodata(token, locked_dataset::WARPED, 0, 0, copies, 1, &nodata, &success) == -CPLE_OpenFailed);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_info_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    char buffer[1 << 12];
+    auto header = reinterpret_cast<info_header_t *>(buffer);
+    int width, height;
+
+    BOOST_TEST(get_info(token, locked_dataset::WARPED, 0, 0, copies, buffer, 4) == -CPLE_IllegalArg);
+    BOOST_TEST(get_info(token, locked_dataset::WARPED, 0, 0, copies, buffer, sizeof(buffer)) > 0);
+    BOOST_TEST(get_width_height(token, locked_dataset::WARPED, 0, 0, copies, &width, &height) > 0);
+    BOOST_TEST(header->size <= static_cast<int>(sizeof(buffer)));
+    BOOST_TEST(header->width == width);
+    BOOST_TEST(header->height == height);
+    BOOST_TEST(header->band_count == 1);
+
+    auto band = reinterpret_cast<info_band_t *>(buffer + sizeof(info_header_t));
+    BOOST_TEST(band->data_type == GDT_Byte);
+    BOOST_TEST(band->has_nodata != 0);
+    BOOST_TEST(band->nodata == 107.0);
+
+    // The WKT is at the end, padded to a multiple of eight bytes
+    auto wkt = buffer + header->size - ((header->crs_wkt_length + 1 + 7) / 8) * 8;
+    BOOST_TEST(std::string(wkt).size() == static_cast<size_t>(header->crs_wkt_length));
 
     deinit();
 }
+
+static int32_t int_at(const char *buffer, size_t offset)
+{
+    int32_t value;
+    memcpy(&value, buffer + offset, sizeof(value));
+    return value;
+}
+
+static double double_at(const char *buffer, size_t offset)
+{
+    double value;
+    memcpy(&value, buffer + offset, sizeof(value));
+    return value;
+}
+
+BOOST_AUTO_TEST_CASE(get_info_layout_example)
+{
+    // The offsets that GDALWarpDataset reads (the INFO_* constants of GDALWarp)
+    BOOST_TEST(sizeof(info_header_t) == 72u);
+    BOOST_TEST(offsetof(info_header_t, size) == 0u);
+    BOOST_TEST(offsetof(info_header_t, width) == 4u);
+    BOOST_TEST(offsetof(info_header_t, height) == 8u);
+    BOOST_TEST(offsetof(info_header_t, band_count) == 12u);
+    BOOST_TEST(offsetof(info_header_t, crs_wkt_length) == 16u);
+    BOOST_TEST(offsetof(info_header_t, transform) == 24u);
+    BOOST_TEST(sizeof(info_band_t) == 56u);
+    BOOST_TEST(offsetof(info_band_t, data_type) == 0u);
+    BOOST_TEST(offsetof(info_band_t, color_interp) == 4u);
+    BOOST_TEST(offsetof(info_band_t, block_width) == 8u);
+    BOOST_TEST(offsetof(info_band_t, block_height) == 12u);
+    BOOST_TEST(offsetof(info_band_t, has_nodata) == 16u);
+    BOOST_TEST(offsetof(info_band_t, has_offset) == 20u);
+    BOOST_TEST(offsetof(info_band_t, has_scale) == 24u);
+    BOOST_TEST(offsetof(info_band_t, overview_count) == 28u);
+    BOOST_TEST(offsetof(info_band_t, nodata) == 32u);
+    BOOST_TEST(offsetof(info_band_t, offset) == 40u);
+    BOOST_TEST(offsetof(info_band_t, scale) == 48u);
+
+    // Two bands, each with two overviews
+    const char *filename = "/vsimem/bindings_tests_info.tif";
+    int overview_list[2] = {2, 4};
+    double transform[6] = {10, 0.5, 0, 20, 0, -0.5};
+    auto ds = GDALCreate(GDALGetDriverByName("GTiff"), filename, 64, 32, 2, GDT_Int16, nullptr);
+    BOOST_TEST(ds != nullptr);
+    GDALSetGeoTransform(ds, transform);
+    GDALSetProjection(ds, SRS_WKT_WGS84_LAT_LONG);
+    GDALSetRasterOffset(GDALGetRasterBand(ds, 1), 1.5);
+    GDALSetRasterScale(GDALGetRasterBand(ds, 1), 0.25);
+    GDALSetRasterNoDataValue(GDALGetRasterBand(ds, 2), -9999);
+    GDALBuildOverviews(ds, "NEAREST", 2, overview_list, 0, nullptr, nullptr, nullptr);
+    GDALClose(ds);
+
+    init(1 << 8);
+
+    auto token = get_token(filename, options);
+    char buffer[1 << 12];
+    BOOST_TEST(get_info(token, locked_dataset::SOURCE, 0, 0, copies, buffer, sizeof(buffer)) > 0);
+
+    // Walk the record as GDALWarpDataset does
+    BOOST_TEST(int_at(buffer, 4) == 64);
+    BOOST_TEST(int_at(buffer, 8) == 32);
+    BOOST_TEST(int_at(buffer, 12) == 2);
+    for (int i = 0; i < 6; ++i)
+    {
+        BOOST_TEST(double_at(buffer, 24 + 8 * i) == transform[i]);
+    }
+    size_t record = 72;
+    for (int b = 0; b < 2; ++b)
+    {
+        BOOST_TEST(int_at(buffer, record + 0) == GDT_Int16);
+        BOOST_TEST(int_at(buffer, record + 8) > 0);
+        BOOST_TEST(int_at(buffer, record + 12) > 0);
+        if (b == 0)
+        {
+            BOOST_TEST(int_at(buffer, record + 20) != 0);
+            BOOST_TEST(int_at(buffer, record + 24) != 0);
+            BOOST_TEST(double_at(buffer, record + 40) == 1.5);
+            BOOST_TEST(double_at(buffer, record + 48) == 0.25);
+        }
+        else
+        {
+            BOOST_TEST(int_at(buffer, record + 16) != 0);
+            BOOST_TEST(double_at(buffer, record + 32) == -9999.0);
+        }
+
+        int overview_count = int_at(buffer, record + 28);
+        BOOST_TEST(overview_count == 2);
+        record += 56;
+        for (int i = 0; i < overview_count; ++i)
+        {
+            BOOST_TEST(int_at(buffer, record + 8 * i) == 64 / overview_list[i]);
+            BOOST_TEST(int_at(buffer, record + 8 * i + 4) == 32 / overview_list[i]);
+        }
+        record += 8 * overview_count;
+    }
+
+    // The WKT follows the last band record and ends the buffer
+    int wkt_length = int_at(buffer, 16);
+    BOOST_TEST(std::string(buffer + record).size() == static_cast<size_t>(wkt_length));
+    BOOST_TEST(static_cast<size_t>(int_at(buffer, 0)) == record + ((wkt_length + 1 + 7) / 8) * 8);
+
+    deinit();
+    VSIUnlink(filename);
+}
+
+BOOST_AUTO_TEST_CASE(get_data_batch_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    // Deliberately out of block order
+    int src_windows[3 * 4] = {600, 600, 32, 32, 0, 0, 32, 32, 300, 0, 32, 32};
+    int dst_windows[3 * 2] = {8, 8, 8, 8, 8, 8};
+    uint8_t expected[3][64];
+    uint8_t actual[3][64];
+    void *data[3] = {actual[0], actual[1], actual[2]};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_TEST(get_data(token, locked_dataset::SOURCE, 0, 0, copies,
+                            src_windows + 4 * i, dst_windows + 2 * i, 1, GDT_Byte, expected[i]) > 0);
+    }
+    BOOST_TEST(get_data_batch(token, locked_dataset::SOURCE, 0, 0, copies, -1,
+                              src_windows, dst_windows, GDT_Byte, data, nullptr) == -CPLE_IllegalArg);
+    BOOST_TEST(get_data_batch(token, locked_dataset::SOURCE, 0, 0, copies, 3,
+                              src_windows, dst_windows, GDT_Byte, data, nullptr) > 0);
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_TEST(memcmp(expected[i], actual[i], 64) == 0);
+    }
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_mosaic_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    double transform[6];
+    BOOST_TEST(get_transform(token, locked_dataset::WARPED, 0, 0, copies, transform) > 0);
+
+    // A 32 × 32 tile of the warped dataset, starting at pixel (10, 20)
+    int src_window[4] = {10, 20, 32, 32};
+    int dst_window[2] = {32, 32};
+    double dst_extent[4] = {
+        transform[0] + 10 * transform[1],
+        transform[3] + 52 * transform[5],
+        transform[0] + 42 * transform[1],
+        transform[3] + 20 * transform[5]};
+    int band_list[1] = {1};
+    uint8_t expected[32 * 32];
+    uint8_t actual[32 * 32];
+    read_options_t read_options;
+
+    INIT_READ_OPTIONS(read_options);
+    read_options.band_count = 1;
+    read_options.band_list = band_list;
+
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, expected) > 0);
+
+    uint64_t tokens[2] = {token, token};
+    BOOST_TEST(get_mosaic(tokens, 2, 0, 0, copies, dst_extent, dst_window, GDT_Byte, actual, nullptr) == -CPLE_IllegalArg);
+    BOOST_TEST(get_mosaic(tokens, 2, 0, 0, copies, dst_extent, dst_window, GDT_Byte, actual, &read_options) > 0);
+    BOOST_TEST(memcmp(expected, actual, sizeof(expected)) == 0);
+
+    uint64_t bad_tokens[2] = {token, 93};
+    BOOST_TEST(get_mosaic(bad_tokens, 2, 0, 0, copies, dst_extent, dst_window, GDT_Byte, actual, &read_options) == -CPLE_OpenFailed);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {0, 0, 256, 256};
+    int dst_window[2] = {16, 16};
+    int bad_window[4] = {0, 0, 0, 0};
+    uint8_t buffer[16 * 16];
+
+    BOOST_TEST(prefetch(token, locked_dataset::SOURCE, 1, 0, copies, src_window, 0, nullptr, 1) == 1);
+    BOOST_TEST(prefetch(token, locked_dataset::WARPED, 1, 0, copies, src_window, 0, nullptr, 0) == 1);
+    BOOST_TEST(prefetch(token, locked_dataset::SOURCE, 4, 1000000000, copies, src_window, 0, nullptr, 1) == 1);
+    BOOST_TEST(prefetch(token, locked_dataset::SOURCE, 1, 0, copies, bad_window, 0, nullptr, 1) == -CPLE_IllegalArg);
+    BOOST_TEST(prefetch(93, locked_dataset::SOURCE, 1, 0, copies, src_window, 0, nullptr, 1) == -CPLE_OpenFailed);
+    BOOST_TEST(get_data(token, locked_dataset::SOURCE, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, buffer) > 0);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(warp_into_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    double transform[6];
+    BOOST_TEST(get_transform(token, locked_dataset::WARPED, 0, 0, copies, transform) > 0);
+
+    // The same grid as a 32 × 32 tile of the warped dataset
+    int src_window[4] = {100, 200, 32, 32};
+    int dst_window[2] = {32, 32};
+    double dst_transform[6] = {
+        transform[0] + 100 * transform[1], transform[1], 0,
+        transform[3] + 200 * transform[5], 0, transform[5]};
+    uint8_t expected[32 * 32];
+    uint8_t actual[32 * 32];
+
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, expected) > 0);
+    BOOST_TEST(warp_into(token, 0, 0, copies, "epsg:3857", dst_transform, dst_window, GRA_Bilinear, GDT_Byte, actual, nullptr) > 0);
+    for (int i = 0; i < 32 * 32; ++i)
+    {
+        BOOST_TEST(std::abs(expected[i] - actual[i]) <= 1);
+    }
+
+    fprintf(stderr, "────────────────────── BEGIN EXPECTED ERROR MESSAGES ─────────────\n");
+    auto retval = warp_into(token, 0, 0, copies, "NOT A CRS", dst_transform, dst_window, GRA_Bilinear, GDT_Byte, actual, nullptr);
+    fprintf(stderr, "────────────────────── END EXPECTED ERROR MESSAGES ───────────────\n");
+    BOOST_TEST(retval == -CPLE_IllegalArg);
+
+    // An empty band list is refused rather than read as "all bands"
+    int no_bands[1] = {0};
+    read_options_t empty;
+    INIT_READ_OPTIONS(empty);
+    empty.band_count = 0;
+    empty.band_list = no_bands;
+    BOOST_TEST(warp_into(token, 0, 0, copies, "epsg:3857", dst_transform, dst_window, GRA_Bilinear, GDT_Byte, actual, &empty) == -CPLE_IllegalArg);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(exact_statistics_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    GUIntBig expected[256];
+    GUIntBig actual[256];
+    double expected_minmax[2];
+    double actual_minmax[2];
+    int success = 0;
+
+    auto ds = GDALOpen(good_uri, GA_ReadOnly);
+    auto band = GDALGetRasterBand(ds, 1);
+    BOOST_TEST(GDALGetRasterHistogramEx(band, -0.5, 255.5, 256, expected, false, false, nullptr, nullptr) == CE_None);
+    BOOST_TEST(GDALComputeRasterMinMax(band, false, expected_minmax) == CE_None);
+    GDALClose(ds);
+
+    BOOST_TEST(get_histogram(token, locked_dataset::SOURCE, 0, 0, copies, 1, -0.5, 255.5, 256, actual, false, false) > 0);
+    for (int i = 0; i < 256; ++i)
+    {
+        BOOST_TEST(expected[i] == actual[i]);
+    }
+    BOOST_TEST(get_band_min_max(token, locked_dataset::SOURCE, 0, 0, copies, 1, false, actual_minmax, &success) > 0);
+    BOOST_TEST(success);
+    BOOST_TEST(actual_minmax[0] == expected_minmax[0]);
+    BOOST_TEST(actual_minmax[1] == expected_minmax[1]);
+
+    // Without overviews, the approximate scan reads a sample of blocks
+    success = 0;
+    BOOST_TEST(get_band_min_max(token, locked_dataset::SOURCE, 0, 0, copies, 1, true, actual_minmax, &success) > 0);
+    BOOST_TEST(success);
+    BOOST_TEST(actual_minmax[0] >= expected_minmax[0]);
+    BOOST_TEST(actual_minmax[1] <= expected_minmax[1]);
+    BOOST_TEST(actual_minmax[0] <= actual_minmax[1]);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_statistics_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    double minimum, maximum, mean, stddev;
+    double percentiles[3] = {0, 50, 100};
+    double percentile_values[3];
+    statistics_t statistics;
+
+    auto ds = GDALOpen(good_uri, GA_ReadOnly);
+    BOOST_TEST(GDALComputeRasterStatistics(GDALGetRasterBand(ds, 1), false, &minimum, &maximum, &mean, &stddev, nullptr, nullptr) == CE_None);
+    GDALClose(ds);
+
+    BOOST_TEST(get_statistics(token, locked_dataset::SOURCE, 0, 0, copies, 1, false, 3, percentiles, percentile_values, &statistics) > 0);
+    BOOST_TEST(statistics.valid_count > 0);
+    BOOST_TEST(statistics.minimum == minimum);
+    BOOST_TEST(statistics.maximum == maximum);
+    BOOST_CHECK_SMALL(statistics.mean - mean, 1e-6);
+    BOOST_CHECK_SMALL(statistics.stddev - stddev, 1e-6);
+    BOOST_TEST(percentile_values[0] == minimum);
+    BOOST_TEST(percentile_values[1] >= minimum);
+    BOOST_TEST(percentile_values[1] <= maximum);
+    BOOST_TEST(percentile_values[2] == maximum);
+
+    const auto valid_count = statistics.valid_count;
+    BOOST_TEST(get_statistics(token, locked_dataset::SOURCE, 0, 0, copies, 1, true, 0, nullptr, nullptr, &statistics) > 0);
+    BOOST_TEST(statistics.valid_count > 0);
+    BOOST_TEST(statistics.valid_count <= valid_count);
+    BOOST_TEST(statistics.minimum >= minimum);
+    BOOST_TEST(statistics.maximum <= maximum);
+    BOOST_TEST(get_statistics(token, locked_dataset::SOURCE, 0, 0, copies, 1, false, 1, nullptr, nullptr, &statistics) == -CPLE_IllegalArg);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(stats_cache_example)
+{
+    setenv("GDALWARP_STATS_CACHE_DIR", "/vsimem/bindings_tests_stats", 1);
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    GUIntBig expected[256];
+    GUIntBig actual[256];
+    statistics_t computed, cached;
+
+    BOOST_TEST(get_histogram(token, locked_dataset::SOURCE, 0, 0, copies, 1, -0.5, 255.5, 256, expected, false, false) > 0);
+    BOOST_TEST(get_histogram(token, locked_dataset::SOURCE, 0, 0, copies, 1, -0.5, 255.5, 256, actual, false, false) == 1);
+    for (int i = 0; i < 256; ++i)
+    {
+        BOOST_TEST(expected[i] == actual[i]);
+    }
+
+    BOOST_TEST(get_statistics(token, locked_dataset::SOURCE, 0, 0, copies, 1, false, 0, nullptr, nullptr, &computed) > 0);
+    BOOST_TEST(get_statistics(token, locked_dataset::SOURCE, 0, 0, copies, 1, false, 0, nullptr, nullptr, &cached) == 1);
+    BOOST_TEST(cached.valid_count == computed.valid_count);
+    BOOST_TEST(cached.mean == computed.mean);
+    BOOST_TEST(cached.stddev == computed.stddev);
+
+    deinit();
+    unsetenv("GDALWARP_STATS_CACHE_DIR");
+}
+
+BOOST_AUTO_TEST_CASE(get_encoded_tile_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {100, 200, 64, 64};
+    int dst_window[2] = {64, 64};
+    uint8_t expected[64 * 64];
+    uint8_t actual[64 * 64];
+    auto tile = std::vector<uint8_t>(1 << 16);
+    int64_t size = 0;
+
+    // PNG is lossless, so decoding the tile gives back the pixels
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, expected) > 0);
+    BOOST_TEST(get_encoded_tile(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                "PNG", nullptr, nullptr, tile.data(), tile.size(), &size) > 0);
+    BOOST_TEST(size > 8);
+    BOOST_TEST(memcmp(tile.data() + 1, "PNG", 3) == 0);
+
+    VSIFCloseL(VSIFileFromMemBuffer("/vsimem/bindings_tests_tile.png", tile.data(), size, FALSE));
+    auto decoded = GDALOpen("/vsimem/bindings_tests_tile.png", GA_ReadOnly);
+    BOOST_TEST(decoded != nullptr);
+    BOOST_TEST(GDALRasterIO(GDALGetRasterBand(decoded, 1), GF_Read, 0, 0, 64, 64, actual, 64, 64, GDT_Byte, 0, 0) == CE_None);
+    BOOST_TEST(memcmp(expected, actual, sizeof(expected)) == 0);
+    GDALClose(decoded);
+    VSIUnlink("/vsimem/bindings_tests_tile.png");
+
+    // Too small a buffer reports the required size
+    int64_t required = 0;
+    BOOST_TEST(get_encoded_tile(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                "PNG", nullptr, nullptr, tile.data(), 8, &required) == -CPLE_AppDefined);
+    BOOST_TEST(required == size);
+
+    // The library-owned buffer holds the same bytes
+    void *buffer = nullptr;
+    int64_t buffer_size = 0;
+    BOOST_TEST(get_encoded_tile_buffer(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                       "PNG", nullptr, nullptr, &buffer, &buffer_size) > 0);
+    BOOST_TEST(buffer_size == size);
+    BOOST_TEST(memcmp(buffer, tile.data(), size) == 0);
+    free_encoded_tile(buffer);
+
+    // A band list without a band count is ignored: all bands are encoded
+    int no_bands[1] = {0};
+    read_options_t all_bands;
+    INIT_READ_OPTIONS(all_bands);
+    all_bands.band_list = no_bands;
+    BOOST_TEST(get_encoded_tile_buffer(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                       "PNG", nullptr, &all_bands, &buffer, &buffer_size) > 0);
+    BOOST_TEST(buffer_size == size);
+    free_encoded_tile(buffer);
+
+    BOOST_TEST(get_encoded_tile(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                "NOT A DRIVER", nullptr, nullptr, tile.data(), tile.size(), &size) == -CPLE_IllegalArg);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(deadline_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {0, 0, 500, 500};
+    int dst_window[2] = {500, 500};
+    auto data = std::vector<uint8_t>(500 * 500);
+    int width, height;
+
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 1000000000000, copies, src_window, dst_window, 1, GDT_Byte, data.data()) > 0);
+    BOOST_TEST(get_width_height(token, locked_dataset::WARPED, 0, 1000000000000, copies, &width, &height) > 0);
+
+    // A budget of one nanosecond is exhausted before the first attempt
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 1, copies, src_window, dst_window, 1, GDT_Byte, data.data()) == -CPLE_FileIO);
+    BOOST_TEST(get_width_height(token, locked_dataset::WARPED, 0, 1, copies, &width, &height) == -CPLE_FileIO);
+
+    deinit();
+}
+
+static std::atomic<int> callbacks_seen(0);
+
+static void count_callback(int64_t id, int result, void *tag)
+{
+    // Reads that deinit cuts short finish with -CPLE_UserInterrupt
+    if ((result > 0 || result == -CPLE_UserInterrupt) && tag == &callbacks_seen)
+    {
+        ++callbacks_seen;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(submit_get_data_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {0, 0, 500, 500};
+    int dst_window[2] = {500, 500};
+    auto expected = std::vector<uint8_t>(500 * 500);
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, expected.data()) > 0);
+
+    // Results through the completion queue
+    const int n = 8;
+    auto data = std::vector<std::vector<uint8_t>>(n, std::vector<uint8_t>(500 * 500));
+    auto tags = std::vector<int>(n);
+    for (int i = 0; i < n; ++i)
+    {
+        BOOST_TEST(submit_get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                   data[i].data(), nullptr, nullptr, &tags[i]) > 0);
+    }
+    int seen = 0;
+    while (seen < n)
+    {
+        int64_t ids[n];
+        int results[n];
+        void *polled_tags[n];
+        int count = poll_completions(ids, results, polled_tags, n, 1000000000);
+        BOOST_REQUIRE(count > 0);
+        for (int i = 0; i < count; ++i)
+        {
+            BOOST_TEST(results[i] > 0);
+            BOOST_TEST(ids[i] > 0);
+            *static_cast<int *>(polled_tags[i]) += 1;
+        }
+        seen += count;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        BOOST_TEST(tags[i] == 1);
+        BOOST_TEST(data[i] == expected);
+    }
+
+    // Results through a callback
+    callbacks_seen = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        BOOST_TEST(submit_get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                   data[i].data(), nullptr, count_callback, &callbacks_seen) > 0);
+    }
+    deinit(); // drains the pool
+    BOOST_TEST(callbacks_seen.load() == n);
+
+    // Reads still queued at deinit are finished, and pollers are told
+    // once their results have been taken
+    init(1 << 8);
+    token = get_token(good_uri, options);
+    for (int i = 0; i < n; ++i)
+    {
+        tags[i] = 0;
+        BOOST_TEST(submit_get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                   data[i].data(), nullptr, nullptr, &tags[i]) > 0);
+    }
+    deinit();
+    BOOST_TEST(submit_get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                               data[0].data(), nullptr, nullptr, nullptr) == -CPLE_AppDefined);
+    seen = 0;
+    while (true)
+    {
+        int64_t ids[n];
+        int results[n];
+        void *polled_tags[n];
+        int count = poll_completions(ids, results, polled_tags, n, 1000000000);
+        if (count < 0)
+        {
+            BOOST_TEST(count == -CPLE_ObjectNull);
+            break;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            BOOST_TEST((results[i] > 0 || results[i] == -CPLE_UserInterrupt));
+            *static_cast<int *>(polled_tags[i]) += 1;
+        }
+        seen += count;
+    }
+    BOOST_TEST(seen == n);
+}
+
+static std::atomic<int> scans_seen(0);
+static std::atomic<int> scans_done(0);
+
+static void scan_callback(int64_t id, int result, void *tag)
+{
+    // Runs on a worker and waits for a scan on the same workers
+    statistics_t statistics;
+    auto token = *static_cast<uint64_t *>(tag);
+    if (result > 0 && get_statistics(token, locked_dataset::SOURCE, 0, 0, copies, 1, false, 0, nullptr, nullptr, &statistics) > 0)
+    {
+        ++scans_seen;
+    }
+    ++scans_done;
+}
+
+BOOST_AUTO_TEST_CASE(blocking_callback_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {0, 0, 500, 500};
+    int dst_window[2] = {500, 500};
+
+    // More callbacks than workers, each waiting on the pool
+    const int n = 2 * static_cast<int>(std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L));
+    auto data = std::vector<std::vector<uint8_t>>(n, std::vector<uint8_t>(500 * 500));
+    scans_seen = 0;
+    scans_done = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        BOOST_TEST(submit_get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Byte,
+                                   data[i].data(), nullptr, scan_callback, &token) > 0);
+    }
+    for (int i = 0; i < 6000 && scans_done.load() < n; ++i)
+    {
+        usleep(10000);
+    }
+    BOOST_TEST(scans_seen.load() == n);
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {0, 0, 500, 500};
+    int dst_window[2] = {500, 500};
+    auto expected = std::vector<uint8_t>(500 * 500);
+    int64_t capacity = 0;
+
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, expected.data()) > 0);
+
+    void *buffer = acquire_buffer(500 * 500, &capacity);
+    BOOST_REQUIRE(buffer != nullptr);
+    BOOST_TEST(capacity >= 500 * 500);
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Byte, buffer) > 0);
+    BOOST_TEST(memcmp(buffer, expected.data(), expected.size()) == 0);
+    BOOST_TEST(release_buffer(buffer) == 1);
+
+    // The idle buffer is handed out again
+    BOOST_TEST(acquire_buffer(500 * 500, nullptr) == buffer);
+    BOOST_TEST(release_buffer(buffer) == 1);
+    BOOST_TEST(release_buffer(expected.data()) == -CPLE_IllegalArg);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_data_arrow_example)
+{
+    init(1 << 8);
+
+    auto token = get_token(good_uri, options);
+    int src_window[4] = {0, 0, 500, 500};
+    int dst_window[2] = {500, 500};
+    auto expected = std::vector<uint16_t>(500 * 500);
+    struct ArrowArray array;
+    struct ArrowSchema schema;
+
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_UInt16, expected.data()) > 0);
+
+    BOOST_TEST(get_data_arrow(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_UInt16, nullptr, 0, &array, &schema) > 0);
+    BOOST_TEST(std::string(schema.format) == "+s");
+    BOOST_REQUIRE(schema.n_children >= 1);
+    BOOST_TEST(std::string(schema.children[0]->format) == "S");
+    BOOST_TEST(std::string(schema.children[0]->name) == "band_1");
+    BOOST_TEST(array.length == 500 * 500);
+    BOOST_REQUIRE(array.n_children == schema.n_children);
+    BOOST_TEST(array.children[0]->null_count == 0);
+    BOOST_TEST(array.children[0]->buffers[0] == nullptr);
+    BOOST_TEST(memcmp(array.children[0]->buffers[1], expected.data(), expected.size() * sizeof(uint16_t)) == 0);
+    BOOST_TEST(reinterpret_cast<uintptr_t>(array.children[0]->buffers[1]) % 64 == 0);
+    array.release(&array);
+    schema.release(&schema);
+    BOOST_TEST(array.release == nullptr);
+    BOOST_TEST(schema.release == nullptr);
+
+    // With validity bitmaps
+    BOOST_TEST(get_data_arrow(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_UInt16, nullptr, 1, &array, &schema) > 0);
+    BOOST_TEST(schema.children[0]->flags == ARROW_FLAG_NULLABLE);
+    BOOST_TEST(memcmp(array.children[0]->buffers[1], expected.data(), expected.size() * sizeof(uint16_t)) == 0);
+    BOOST_TEST((array.children[0]->null_count == 0) == (array.children[0]->buffers[0] == nullptr));
+    array.release(&array);
+    schema.release(&schema);
+
+    // 64-bit integers
+    auto wide = std::vector<int64_t>(500 * 500);
+    BOOST_TEST(get_data(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, 1, GDT_Int64, wide.data()) > 0);
+    BOOST_TEST(get_data_arrow(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_Int64, nullptr, 0, &array, &schema) > 0);
+    BOOST_TEST(std::string(schema.children[0]->format) == "l");
+    BOOST_TEST(memcmp(array.children[0]->buffers[1], wide.data(), wide.size() * sizeof(int64_t)) == 0);
+    array.release(&array);
+    schema.release(&schema);
+    BOOST_TEST(get_data_arrow(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_UInt64, nullptr, 0, &array, &schema) > 0);
+    BOOST_TEST(std::string(schema.children[0]->format) == "L");
+    array.release(&array);
+    schema.release(&schema);
+
+    BOOST_TEST(get_data_arrow(token, locked_dataset::WARPED, 0, 0, copies, src_window, dst_window, GDT_CInt16, nullptr, 0, &array, &schema) == -CPLE_NotSupported);
+
+    deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_read_options_layout_example)
+{
+    int64_t layout[13];
+
+    BOOST_TEST(get_read_options_layout(layout, 12) == -CPLE_IllegalArg);
+    BOOST_TEST(get_read_options_layout(layout, 13) == 13);
+    BOOST_TEST(layout[0] == static_cast<int64_t>(sizeof(read_options_t)));
+    BOOST_TEST(layout[2] == static_cast<int64_t>(offsetof(read_options_t, band_list)));
+    BOOST_TEST(layout[10] == static_cast<int64_t>(offsetof(read_options_t, fractional_window)));
+    BOOST_TEST(layout[12] == static_cast<int64_t>(offsetof(read_options_t, mask_packed)));
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Buffer Layout Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "buffer_layout.h"
+
+BOOST_AUTO_TEST_CASE(default_spacing)
+{
+    int64_t band[3] = {0, 0, 0};
+    int64_t pixel[3] = {0, 0, 0};
+    int64_t line[3] = {0, 0, 0};
+    int64_t given[3] = {0, 64, 0};
+    int64_t unknown[3] = {0, 0, 0};
+
+    // 10 × 5 pixels of Int16 in 3 bands
+    BOOST_TEST(resolve_spacing(INTERLEAVE_BAND, GDT_Int16, 10, 5, 3, band) == 1);
+    BOOST_TEST(band[0] == 2);
+    BOOST_TEST(band[1] == 20);
+    BOOST_TEST(band[2] == 100);
+    BOOST_TEST(resolve_spacing(INTERLEAVE_PIXEL, GDT_Int16, 10, 5, 3, pixel) == 1);
+    BOOST_TEST(pixel[0] == 6);
+    BOOST_TEST(pixel[1] == 60);
+    BOOST_TEST(pixel[2] == 2);
+    BOOST_TEST(resolve_spacing(INTERLEAVE_LINE, GDT_Int16, 10, 5, 3, line) == 1);
+    BOOST_TEST(line[0] == 2);
+    BOOST_TEST(line[1] == 60);
+    BOOST_TEST(line[2] == 20);
+
+    // Spacings that are given are kept
+    BOOST_TEST(resolve_spacing(INTERLEAVE_BAND, GDT_Int16, 10, 5, 3, given) == 1);
+    BOOST_TEST(given[1] == 64);
+    BOOST_TEST(given[2] == 100);
+
+    BOOST_TEST(resolve_spacing(42, GDT_Int16, 10, 5, 3, unknown) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(fits_direct_buffer)
+{
+    int64_t spacing[3] = {0, 0, 0};
+    BOOST_TEST(resolve_spacing(INTERLEAVE_PIXEL, GDT_Float32, 16, 16, 2, spacing) == 1);
+    const int64_t needed = 16 * 16 * 2 * 4;
+
+    // A read at the position of a direct buffer must end within its capacity
+    BOOST_TEST(fits(0, GDT_Float32, 16, 16, 2, spacing, needed) == 1);
+    BOOST_TEST(fits(0, GDT_Float32, 16, 16, 2, spacing, needed - 1) == 0);
+    BOOST_TEST(fits(100, GDT_Float32, 16, 16, 2, spacing, needed + 100) == 1);
+    BOOST_TEST(fits(101, GDT_Float32, 16, 16, 2, spacing, needed + 100) == 0);
+    BOOST_TEST(fits(-1, GDT_Float32, 16, 16, 2, spacing, needed) == 0);
+
+    // Padded lines count towards the extent
+    int64_t padded[3] = {8, 8 * 16 + 32, 4};
+    BOOST_TEST(fits(0, GDT_Float32, 16, 16, 2, padded, 15 * (8 * 16 + 32) + 8 * 16) == 1);
+    BOOST_TEST(fits(0, GDT_Float32, 16, 16, 2, padded, 15 * (8 * 16 + 32) + 8 * 16 - 1) == 0);
+
+    // Negative spacings (bottom-up lines) reach below the offset
+    int64_t bottom_up[3] = {4, -64, 64 * 16};
+    const int64_t start = 15 * 64;
+    BOOST_TEST(fits(start, GDT_Float32, 16, 16, 2, bottom_up, needed) == 1);
+    BOOST_TEST(fits(start - 1, GDT_Float32, 16, 16, 2, bottom_up, needed) == 0);
+
+    // Empty reads do not fit anywhere
+    BOOST_TEST(fits(0, GDT_Float32, 0, 16, 2, spacing, needed) == 0);
+    BOOST_TEST(fits(0, GDT_Float32, 16, 16, 0, spacing, needed) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(typed_element_sizes)
+{
+    // short[], int[], float[] and double[] take their own types
+    BOOST_TEST(element_size_matches(GDT_Int16, 2) == 1);
+    BOOST_TEST(element_size_matches(GDT_Int32, 4) == 1);
+    BOOST_TEST(element_size_matches(GDT_Float32, 4) == 1);
+    BOOST_TEST(element_size_matches(GDT_Float64, 8) == 1);
+
+    // Unsigned types of the same size, and complex types by component
+    BOOST_TEST(element_size_matches(GDT_UInt16, 2) == 1);
+    BOOST_TEST(element_size_matches(GDT_UInt32, 4) == 1);
+    BOOST_TEST(element_size_matches(GDT_CInt16, 2) == 1);
+    BOOST_TEST(element_size_matches(GDT_CFloat32, 4) == 1);
+    BOOST_TEST(element_size_matches(GDT_CFloat64, 8) == 1);
+
+    // Mismatched and unknown types are refused
+    BOOST_TEST(element_size_matches(GDT_Byte, 2) == 0);
+    BOOST_TEST(element_size_matches(GDT_Float64, 4) == 0);
+    BOOST_TEST(element_size_matches(GDT_CInt16, 4) == 0);
+    BOOST_TEST(element_size_matches(GDT_Unknown, 0) == 0);
+    BOOST_TEST(element_size_matches(1000, 8) == 0);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Buffer Pool Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstring>
+
+#include "buffer_pool.hpp"
+
+BOOST_AUTO_TEST_CASE(aligned_and_rounded)
+{
+    buffer_pool pool(1 << 20, false);
+    size_t capacity = 0;
+
+    void *buffer = pool.acquire(5000, &capacity);
+    BOOST_REQUIRE(buffer != nullptr);
+    BOOST_TEST(capacity == 8192);
+    BOOST_TEST(reinterpret_cast<uintptr_t>(buffer) % static_cast<uintptr_t>(buffer_pool::PAGE) == 0);
+    memset(buffer, 0xff, capacity);
+    BOOST_TEST(pool.release(buffer));
+}
+
+BOOST_AUTO_TEST_CASE(reused)
+{
+    buffer_pool pool(1 << 20, false);
+
+    void *first = pool.acquire(4096, nullptr);
+    BOOST_TEST(pool.release(first));
+    BOOST_TEST(pool.idle_bytes() == 4096);
+
+    // Same size class
+    void *second = pool.acquire(1000, nullptr);
+    BOOST_TEST(second == first);
+    BOOST_TEST(pool.idle_bytes() == 0);
+    BOOST_TEST(pool.release(second));
+}
+
+BOOST_AUTO_TEST_CASE(capacity_bounds_idle_bytes)
+{
+    buffer_pool pool(8192, false);
+
+    void *a = pool.acquire(8192, nullptr);
+    void *b = pool.acquire(8192, nullptr);
+    BOOST_TEST(pool.release(a));
+    BOOST_TEST(pool.release(b)); // freed rather than kept
+    BOOST_TEST(pool.idle_bytes() == 8192);
+}
+
+BOOST_AUTO_TEST_CASE(foreign_buffers_rejected)
+{
+    buffer_pool pool(1 << 20, false);
+    int x;
+
+    BOOST_TEST(!pool.release(&x));
+}
+
+BOOST_AUTO_TEST_CASE(hugepages)
+{
+    buffer_pool pool(1 << 22, true);
+
+    void *buffer = pool.acquire(3 << 20, nullptr);
+    BOOST_REQUIRE(buffer != nullptr);
+    BOOST_TEST(reinterpret_cast<uintptr_t>(buffer) % static_cast<uintptr_t>(buffer_pool::HUGE_PAGE) == 0);
+    BOOST_TEST(pool.release(buffer));
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Byte Order Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include "byte_order.h"
+
+// Reverse each size-byte element one byte at a time
+static std::vector<uint8_t> reference(const std::vector<uint8_t> &bytes, int size)
+{
+    auto retval = bytes;
+    for (size_t i = 0; i + size <= retval.size(); i += size)
+    {
+        for (int j = 0; j < size / 2; ++j)
+        {
+            std::swap(retval[i + j], retval[i + size - 1 - j]);
+        }
+    }
+    return retval;
+}
+
+static std::vector<uint8_t> pattern(size_t length)
+{
+    auto retval = std::vector<uint8_t>(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+        retval[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(matches_scalar)
+{
+    // Element counts below, at and above the vector width, with remainders
+    for (int size : {2, 4, 8})
+    {
+        for (size_t count = 0; count < 40; ++count)
+        {
+            auto bytes = pattern(count * size);
+            auto expected = reference(bytes, size);
+            swap_big_endian(bytes.data(), count, size);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            BOOST_TEST(bytes == pattern(count * size));
+#else
+            BOOST_TEST(bytes == expected);
+#endif
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unaligned)
+{
+    auto bytes = pattern(1 + 64 * 4);
+    auto expected = bytes;
+    auto tail = reference(std::vector<uint8_t>(bytes.begin() + 1, bytes.end()), 4);
+    std::copy(tail.begin(), tail.end(), expected.begin() + 1);
+
+    swap_big_endian(bytes.data() + 1, 64, 4);
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+    BOOST_TEST(bytes == expected);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(single_bytes_untouched)
+{
+    auto bytes = pattern(17);
+    swap_big_endian(bytes.data(), 17, 1);
+    BOOST_TEST(bytes == pattern(17));
+}
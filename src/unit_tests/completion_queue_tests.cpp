@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Completion Queue Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <pthread.h>
+
+#include "completion_queue.hpp"
+
+BOOST_AUTO_TEST_CASE(poll_empty)
+{
+    completion_queue queue;
+    completion_queue::completion_t completions[4];
+
+    BOOST_TEST(queue.poll(completions, 4, 0) == 0);
+    BOOST_TEST(queue.poll(completions, 4, 1000000) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(poll_in_order)
+{
+    completion_queue queue;
+    completion_queue::completion_t completions[2];
+    int tag;
+
+    queue.push(1, 10, nullptr);
+    queue.push(2, -3, &tag);
+    queue.push(3, 30, nullptr);
+    BOOST_TEST(queue.size() == 3);
+
+    BOOST_TEST(queue.poll(completions, 2, 0) == 2);
+    BOOST_TEST(completions[0].id == 1);
+    BOOST_TEST(completions[0].result == 10);
+    BOOST_TEST(completions[1].id == 2);
+    BOOST_TEST(completions[1].result == -3);
+    BOOST_TEST(completions[1].tag == &tag);
+
+    BOOST_TEST(queue.poll(completions, 2, 0) == 1);
+    BOOST_TEST(completions[0].id == 3);
+    BOOST_TEST(queue.size() == 0);
+}
+
+static void *push_later(void *arg)
+{
+    struct timespec ts = {0, 10000000};
+    nanosleep(&ts, nullptr);
+    static_cast<completion_queue *>(arg)->push(42, 1, nullptr);
+    return nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(poll_waits)
+{
+    completion_queue queue;
+    completion_queue::completion_t completion;
+    pthread_t thread;
+
+    pthread_create(&thread, nullptr, push_later, &queue);
+    BOOST_TEST(queue.poll(&completion, 1, 10000000000) == 1);
+    BOOST_TEST(completion.id == 42);
+    pthread_join(thread, nullptr);
+}
+
+static void *close_later(void *arg)
+{
+    struct timespec ts = {0, 10000000};
+    nanosleep(&ts, nullptr);
+    static_cast<completion_queue *>(arg)->set_closed(true);
+    return nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(poll_closed)
+{
+    completion_queue queue;
+    completion_queue::completion_t completion;
+    pthread_t thread;
+
+    // Closing wakes a waiting poll
+    pthread_create(&thread, nullptr, close_later, &queue);
+    BOOST_TEST(queue.poll(&completion, 1, 10000000000) == -1);
+    pthread_join(thread, nullptr);
+
+    // Completions that remain are still taken
+    queue.push(7, 1, nullptr);
+    BOOST_TEST(queue.poll(&completion, 1, 0) == 1);
+    BOOST_TEST(completion.id == 7);
+    BOOST_TEST(queue.poll(&completion, 1, 1000000) == -1);
+
+    queue.set_closed(false);
+    BOOST_TEST(queue.poll(&completion, 1, 0) == 0);
+}
@@ -490,6 +490,317 @@ BOOST_AUTO_TEST_CASE(get_pixels_test)
     errno_deinit();
 }
 
+BOOST_AUTO_TEST_CASE(get_pixels_ex_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    int src_window[4] = {33, 42, 100, 100};
+    int dst_window[2] = {4, 2};
+    int band_list[2] = {1, 1};
+    uint8_t expected[8];
+    uint8_t band_sequential[16];
+    uint8_t pixel_interleaved[16];
+    read_options_t options;
+
+    errno_init();
+
+    INIT_READ_OPTIONS(options);
+    options.band_count = 2;
+    options.band_list = band_list;
+
+    BOOST_TEST(ld.get_pixels(locked_dataset::WARPED, src_window, dst_window, 1, GDT_Byte, expected) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, band_sequential, &options) == ATTEMPT_SUCCESSFUL);
+    options.interleave = INTERLEAVE_PIXEL;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, pixel_interleaved, &options) == ATTEMPT_SUCCESSFUL);
+    options.interleave = 42;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, pixel_interleaved, &options) == -CPLE_IllegalArg);
+    options.interleave = INTERLEAVE_BAND;
+
+    // A band list needs a positive band count; without one, all bands are read
+    options.band_count = 0;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, band_sequential, &options) == -CPLE_IllegalArg);
+    options.band_list = nullptr;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, band_sequential, &options) == ATTEMPT_SUCCESSFUL);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        BOOST_TEST(band_sequential[i] == expected[i]);
+        BOOST_TEST(band_sequential[i + 8] == expected[i]);
+        BOOST_TEST(pixel_interleaved[2 * i] == expected[i]);
+        BOOST_TEST(pixel_interleaved[2 * i + 1] == expected[i]);
+    }
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_pixels_ex_strided_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    int src_window[4] = {33, 42, 100, 100};
+    int dst_window[2] = {4, 2};
+    uint8_t expected[8];
+    uint8_t padded[3 * 10];
+    read_options_t options;
+
+    errno_init();
+
+    INIT_READ_OPTIONS(options);
+    options.band_count = 1;
+    options.pixel_space = 2; // every other byte
+    options.line_space = 10; // lines padded to 10 bytes
+    memset(padded, 0xff, sizeof(padded));
+
+    BOOST_TEST(ld.get_pixels(locked_dataset::WARPED, src_window, dst_window, 1, GDT_Byte, expected) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, padded + 11, &options) == ATTEMPT_SUCCESSFUL);
+
+    for (int y = 0; y < 2; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            BOOST_TEST(padded[11 + y * 10 + x * 2] == expected[y * 4 + x]);
+            BOOST_TEST(padded[11 + y * 10 + x * 2 + 1] == 0xff);
+        }
+    }
+    BOOST_TEST(padded[10] == 0xff);
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_pixels_ex_mask_test)
+{
+    auto ld = locked_dataset(uri_options2);
+    int src_window[4] = {0, 0, 100, 100};
+    int dst_window[2] = {10, 10};
+    uint8_t expected_pixels[100];
+    uint8_t expected_mask[100];
+    uint8_t pixels[100];
+    uint8_t mask[100];
+    uint8_t packed[MASK_BYTES(10, 10, 1)];
+    read_options_t options;
+
+    errno_init();
+
+    INIT_READ_OPTIONS(options);
+    BOOST_TEST(ld.get_pixels(locked_dataset::WARPED, src_window, dst_window, 1, GDT_Byte, expected_pixels) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.get_mask(locked_dataset::WARPED, src_window, dst_window, 1, expected_mask) == ATTEMPT_SUCCESSFUL);
+
+    // One byte per pixel
+    options.mask = mask;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, pixels, &options) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(memcmp(pixels, expected_pixels, sizeof(pixels)) == 0);
+    BOOST_TEST(memcmp(mask, expected_mask, sizeof(mask)) == 0);
+
+    // One bit per pixel
+    options.mask = packed;
+    options.mask_packed = 1;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::WARPED, src_window, dst_window, GDT_Byte, pixels, &options) == ATTEMPT_SUCCESSFUL);
+    for (int i = 0; i < 100; ++i)
+    {
+        BOOST_TEST(((packed[i / 8] >> (i % 8)) & 1) == (expected_mask[i] != 0));
+    }
+    BOOST_TEST((packed[12] >> 4) == 0);
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_pixels_batch_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    int block_width, block_height;
+    BOOST_TEST(ld.get_block_size(locked_dataset::SOURCE, 1, &block_width, &block_height) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(block_width > 0);
+
+    // Second block row, then two windows in the first block row
+    int src_windows[3 * 4] = {
+        0, block_height, 4, 2,
+        4, 0, 4, 2,
+        0, 0, 4, 2};
+    int dst_windows[3 * 2] = {4, 2, 4, 2, 4, 2};
+    uint8_t expected[3][8];
+    uint8_t actual[3][8];
+    void *data[3] = {actual[0], actual[1], actual[2]};
+    int order[3];
+    int next = 0;
+    read_options_t options;
+
+    errno_init();
+
+    INIT_READ_OPTIONS(options);
+    options.band_count = 1;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_TEST(ld.get_pixels(locked_dataset::SOURCE, src_windows + 4 * i, dst_windows + 2 * i, 1, GDT_Byte, expected[i]) == ATTEMPT_SUCCESSFUL);
+    }
+
+    // A locked dataset makes no progress
+    BOOST_TEST(ld.lock_for_deletion());
+    BOOST_TEST(ld.get_pixels_batch(locked_dataset::SOURCE, 3, src_windows, dst_windows, GDT_Byte, data, &options, order, &next) == DATASET_LOCKED);
+    BOOST_TEST(next == 0);
+    ld.unlock_for_nondeletion();
+
+    BOOST_TEST(ld.get_pixels_batch(locked_dataset::SOURCE, 3, src_windows, dst_windows, GDT_Byte, data, &options, order, &next) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(next == 3);
+    BOOST_TEST(order[0] == 2);
+    BOOST_TEST(order[1] == 1);
+    BOOST_TEST(order[2] == 0);
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_TEST(memcmp(expected[i], actual[i], 8) == 0);
+    }
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_pixels_ex_overview_test)
+{
+    const char *filename = "/vsimem/overview_test.tif";
+    int overview_list[1] = {2};
+    int src_window[4] = {0, 0, 64, 32};
+    int dst_window[2] = {64, 32};
+    uint8_t expected[64 * 32];
+    uint8_t actual[64 * 32];
+    int expected_block[2], actual_block[2];
+    read_options_t options;
+
+    errno_init();
+
+    // An in-memory copy of the test file with one 2× overview
+    auto src = GDALOpen(uri1.c_str(), GA_ReadOnly);
+    auto dst = GDALCreateCopy(GDALGetDriverByName("GTiff"), filename, src, FALSE, nullptr, nullptr, nullptr);
+    GDALBuildOverviews(dst, "NEAREST", 1, overview_list, 0, nullptr, nullptr, nullptr);
+    BOOST_TEST(GDALRasterIO(GDALGetOverview(GDALGetRasterBand(dst, 1), 0), GF_Read,
+                            src_window[0], src_window[1], src_window[2], src_window[3],
+                            expected, dst_window[0], dst_window[1], GDT_Byte, 0, 0) == CE_None);
+    GDALGetBlockSize(GDALGetOverview(GDALGetRasterBand(dst, 1), 0), &expected_block[0], &expected_block[1]);
+    GDALClose(dst);
+    GDALClose(src);
+
+    {
+        auto ld = locked_dataset(std::make_pair(uri_t(filename), options1));
+        INIT_READ_OPTIONS(options);
+        options.overview = 0;
+        BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, dst_window, GDT_Byte, actual, &options) == ATTEMPT_SUCCESSFUL);
+        BOOST_TEST(memcmp(expected, actual, sizeof(actual)) == 0);
+
+        options.overview = 1;
+        BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, dst_window, GDT_Byte, actual, &options) == -CPLE_IllegalArg);
+
+        // Overviews have block sizes of their own
+        BOOST_TEST(ld.get_overview_block_size(locked_dataset::SOURCE, 1, 0, &actual_block[0], &actual_block[1]) == ATTEMPT_SUCCESSFUL);
+        BOOST_TEST(actual_block[0] == expected_block[0]);
+        BOOST_TEST(actual_block[1] == expected_block[1]);
+        BOOST_TEST(ld.get_overview_block_size(locked_dataset::SOURCE, 1, 1, &actual_block[0], &actual_block[1]) == -CPLE_IllegalArg);
+    }
+    VSIUnlink(filename);
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(get_pixels_ex_resampling_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    int src_window[4] = {1000, 1000, 4, 4};
+    int full_window[2] = {4, 4};
+    int half_window[2] = {2, 2};
+    uint8_t full[16];
+    uint8_t averaged[4];
+    uint8_t fractional[16];
+    read_options_t options;
+
+    errno_init();
+
+    INIT_READ_OPTIONS(options);
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, full_window, GDT_Byte, full, &options) == ATTEMPT_SUCCESSFUL);
+
+    // Averaging 2×2 neighbourhoods
+    options.resampling = GRIORA_Average;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, half_window, GDT_Byte, averaged, &options) == ATTEMPT_SUCCESSFUL);
+    for (int y = 0; y < 2; ++y)
+    {
+        for (int x = 0; x < 2; ++x)
+        {
+            double mean = (full[(2 * y) * 4 + 2 * x] + full[(2 * y) * 4 + 2 * x + 1] +
+                           full[(2 * y + 1) * 4 + 2 * x] + full[(2 * y + 1) * 4 + 2 * x + 1]) /
+                          4.0;
+            BOOST_CHECK_SMALL(averaged[y * 2 + x] - mean, 1.0);
+        }
+    }
+
+    // A fractional window on pixel boundaries is the same as the integer one
+    options.resampling = GRIORA_NearestNeighbour;
+    options.has_fractional_window = 1;
+    options.fractional_window[0] = 1000.0;
+    options.fractional_window[1] = 1000.0;
+    options.fractional_window[2] = 4.0;
+    options.fractional_window[3] = 4.0;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, full_window, GDT_Byte, fractional, &options) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(memcmp(full, fractional, sizeof(full)) == 0);
+
+    options.fractional_window[2] = -1.0;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, full_window, GDT_Byte, fractional, &options) == -CPLE_IllegalArg);
+    options.has_fractional_window = 0;
+    options.resampling = 9;
+    BOOST_TEST(ld.get_pixels_ex(locked_dataset::SOURCE, src_window, full_window, GDT_Byte, fractional, &options) == -CPLE_IllegalArg);
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    int src_window[4] = {0, 0, 100, 100};
+    int band_list[1] = {42};
+
+    errno_init();
+
+    BOOST_TEST(ld.prefetch(locked_dataset::SOURCE, src_window, 0, nullptr, false) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.prefetch(locked_dataset::SOURCE, src_window, 0, nullptr, true) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.prefetch(locked_dataset::WARPED, src_window, 1, nullptr, true) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.prefetch(locked_dataset::SOURCE, src_window, 1, band_list, true) == -CPLE_IllegalArg);
+
+    BOOST_TEST(ld.lock_for_deletion());
+    BOOST_TEST(ld.prefetch(locked_dataset::SOURCE, src_window, 0, nullptr, true) == DATASET_LOCKED);
+    ld.unlock_for_nondeletion();
+
+    errno_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(warp_into_cached_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    transformer_cache transformers(4);
+    char wkt[1 << 12];
+    double transform[6];
+    int dst_size[2] = {32, 32};
+    uint8_t expected[32 * 32];
+    uint8_t actual[32 * 32];
+    read_options_t options;
+
+    errno_init();
+
+    INIT_READ_OPTIONS(options);
+    BOOST_TEST(ld.get_crs_wkt(locked_dataset::WARPED, wkt, sizeof(wkt)) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(ld.get_transform(locked_dataset::WARPED, transform) == ATTEMPT_SUCCESSFUL);
+    transform[0] += 100 * transform[1];
+    transform[3] += 200 * transform[5];
+
+    BOOST_TEST(ld.warp_into(wkt, transform, dst_size, GRA_Bilinear, GDT_Byte, expected, &options, nullptr) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(transformers.size() == 0);
+
+    // The second warp reuses the transformations checked in by the first
+    for (int i = 0; i < 2; ++i)
+    {
+        BOOST_TEST(ld.warp_into(wkt, transform, dst_size, GRA_Bilinear, GDT_Byte, actual, &options, &transformers) == ATTEMPT_SUCCESSFUL);
+        BOOST_TEST(transformers.size() == 1);
+        for (int j = 0; j < 32 * 32; ++j)
+        {
+            BOOST_TEST(std::abs(expected[j] - actual[j]) <= 1);
+        }
+    }
+
+    errno_deinit();
+}
+
 BOOST_AUTO_TEST_CASE(good_pixels_bad_requests)
 {
     auto ld = locked_dataset(uri_options1);
@@ -554,6 +865,37 @@ BOOST_AUTO_TEST_CASE(width_height_test)
     errno_deinit();
 }
 
+BOOST_AUTO_TEST_CASE(metadata_while_locked_test)
+{
+    auto ld = locked_dataset(uri_options1);
+    int width = -1;
+    int height = -1;
+    double transform[6];
+    char crs[1 << 10];
+    GDALDataType data_type;
+
+    errno_init();
+
+    // Take the dataset lock as a concurrent reader would
+    BOOST_TEST(ld.lock_for_deletion());
+
+    BOOST_TEST(ld.noop() == DATASET_LOCKED);
+    BOOST_TEST(ld.get_width_height(locked_dataset::WARPED, &width, &height) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(width == 7319);
+    BOOST_TEST(height == 5771);
+    BOOST_TEST(ld.get_transform(locked_dataset::WARPED, transform) == ATTEMPT_SUCCESSFUL);
+    BOOST_CHECK_SMALL(transform[1] - 33.88424960091178, EPSILON);
+    BOOST_TEST(ld.get_crs_wkt(locked_dataset::WARPED, crs, sizeof(crs)) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(std::string(crs).find("Pseudo-Mercator") != std::string::npos);
+    BOOST_TEST(ld.get_band_data_type(locked_dataset::WARPED, 1, &data_type) == ATTEMPT_SUCCESSFUL);
+    BOOST_TEST(data_type == GDT_Byte);
+    BOOST_TEST(ld.get_band_data_type(locked_dataset::WARPED, 42, &data_type) == -CPLE_IllegalArg);
+
+    ld.unlock_for_nondeletion();
+
+    errno_deinit();
+}
+
 BOOST_AUTO_TEST_CASE(destroy)
 {
     GDALDestroyDriverManager();
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Deadline Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+
+#include <cpl_conv.h>
+
+#include "deadline.hpp"
+
+constexpr uint64_t SECOND = 1000000000;
+
+BOOST_AUTO_TEST_CASE(no_deadline)
+{
+    BOOST_TEST(current_deadline() == 0);
+    BOOST_TEST(deadline_progress(0.5, nullptr, nullptr) == TRUE);
+    {
+        deadline_scope scope(0);
+        BOOST_TEST(current_deadline() == 0);
+        BOOST_TEST(CPLGetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", nullptr) == nullptr);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(passed_deadline)
+{
+    auto now = get_nanos();
+    {
+        deadline_scope scope(now - 1);
+        BOOST_TEST(deadline_progress(0.5, nullptr, nullptr) == FALSE);
+    }
+    BOOST_TEST(current_deadline() == 0);
+    BOOST_TEST(deadline_progress(0.5, nullptr, nullptr) == TRUE);
+}
+
+BOOST_AUTO_TEST_CASE(nested_deadlines)
+{
+    auto now = get_nanos();
+    {
+        deadline_scope outer(now + 10 * SECOND);
+        BOOST_TEST(current_deadline() == now + 10 * SECOND);
+        {
+            // A later deadline does not extend an earlier one
+            deadline_scope inner(now + 20 * SECOND);
+            BOOST_TEST(current_deadline() == now + 10 * SECOND);
+        }
+        {
+            deadline_scope inner(now + 5 * SECOND);
+            BOOST_TEST(current_deadline() == now + 5 * SECOND);
+        }
+        BOOST_TEST(current_deadline() == now + 10 * SECOND);
+        BOOST_TEST(deadline_progress(0.5, nullptr, nullptr) == TRUE);
+    }
+    BOOST_TEST(current_deadline() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(http_timeout)
+{
+    auto now = get_nanos();
+    {
+        deadline_scope scope(now + 3 * SECOND);
+        BOOST_TEST(std::string(CPLGetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", "")) == "3");
+    }
+    BOOST_TEST(CPLGetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", nullptr) == nullptr);
+
+    // A shorter timeout that is already set is kept
+    CPLSetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", "1");
+    {
+        deadline_scope scope(now + 3 * SECOND);
+        BOOST_TEST(std::string(CPLGetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", "")) == "1");
+    }
+    BOOST_TEST(std::string(CPLGetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", "")) == "1");
+    CPLSetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(remaining_budget)
+{
+    BOOST_TEST(deadline_after(0) == 0);
+    BOOST_TEST(nanos_until(0) == 0);
+    BOOST_TEST(!deadline_passed(0));
+
+    auto deadline = deadline_after(10 * SECOND);
+    BOOST_TEST(nanos_until(deadline) > 0);
+    BOOST_TEST(nanos_until(deadline) <= 10 * SECOND);
+    BOOST_TEST(!deadline_passed(deadline));
+
+    // A passed deadline leaves a budget that fails at once
+    auto now = get_nanos();
+    BOOST_TEST(nanos_until(now - 1) == 1);
+    BOOST_TEST(deadline_passed(now - 1));
+
+    // An earlier deadline of the current thread wins
+    {
+        deadline_scope scope(now + SECOND);
+        BOOST_TEST(deadline_after(10 * SECOND) == now + SECOND);
+        BOOST_TEST(deadline_after(0) == now + SECOND);
+    }
+}
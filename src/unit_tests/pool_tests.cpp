@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Worker Pool Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+
+#include "worker_pool.hpp"
+
+BOOST_AUTO_TEST_CASE(init)
+{
+    worker_pool pool(4);
+    BOOST_TEST(pool.size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(task_group_waits)
+{
+    worker_pool pool(4);
+    std::atomic<int> sum{0};
+    task_group group;
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        group.run(&pool, [&sum, i]() { sum += i; });
+    }
+    group.wait();
+
+    BOOST_TEST(sum.load() == 5050);
+}
+
+BOOST_AUTO_TEST_CASE(task_group_waits_on_worker)
+{
+    // With one thread, the waiting task is the only worker, so the
+    // group's tasks complete only if the waiter runs them itself
+    std::atomic<int> sum{0};
+    std::atomic<bool> done{false};
+    {
+        worker_pool pool(1);
+        pool.submit([&pool, &sum, &done]() {
+            task_group group;
+            for (int i = 1; i <= 100; ++i)
+            {
+                group.run(&pool, [&sum, i]() { sum += i; });
+            }
+            group.wait();
+            done = (sum.load() == 5050);
+        });
+    }
+
+    BOOST_TEST(done.load());
+    BOOST_TEST(sum.load() == 5050);
+}
+
+BOOST_AUTO_TEST_CASE(synchronous_without_threads)
+{
+    worker_pool pool(0);
+    int count = 0;
+    task_group group;
+
+    group.run(&pool, [&count]() { ++count; });
+    BOOST_TEST(count == 1);
+    group.run(nullptr, [&count]() { ++count; });
+    BOOST_TEST(count == 2);
+}
+
+BOOST_AUTO_TEST_CASE(destructor_drains)
+{
+    std::atomic<int> count{0};
+    {
+        worker_pool pool(2);
+        for (int i = 0; i < 64; ++i)
+        {
+            pool.submit([&count]() { ++count; });
+        }
+    }
+    BOOST_TEST(count.load() == 64);
+}
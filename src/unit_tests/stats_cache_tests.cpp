@@ -0,0 +1,105 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Statistics Cache Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gdal.h>
+
+#include "stats_cache.hpp"
+
+static void write_file(const char *path, const std::string &contents)
+{
+    VSILFILE *file = VSIFOpenL(path, "wb");
+    VSIFWriteL(contents.data(), 1, contents.size(), file);
+    VSIFCloseL(file);
+}
+
+BOOST_AUTO_TEST_CASE(init)
+{
+    GDALAllRegister();
+}
+
+BOOST_AUTO_TEST_CASE(put_get_round_trip)
+{
+    auto cache = stats_cache("/vsimem/stats_cache_tests/a");
+    auto expected = std::vector<double>{1, 2.5, -3e300, 0.1};
+    auto actual = std::vector<double>();
+
+    BOOST_TEST(!cache.get("key", "validator", &actual));
+    cache.put("key", "validator", expected);
+    BOOST_TEST(cache.get("key", "validator", &actual));
+    BOOST_TEST((actual == expected));
+
+    // A different validator (the dataset changed) or key misses
+    BOOST_TEST(!cache.get("key", "other validator", &actual));
+    BOOST_TEST(!cache.get("other key", "validator", &actual));
+
+    // Entries persist across instances
+    auto again = stats_cache("/vsimem/stats_cache_tests/a");
+    BOOST_TEST(again.get("key", "validator", &actual));
+    BOOST_TEST((actual == expected));
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_puts)
+{
+    auto cache = stats_cache("/vsimem/stats_cache_tests/b");
+    auto threads = std::vector<std::thread>();
+
+    // Every thread writes its own entry under the same key
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&cache, i]() {
+            for (int j = 0; j < 64; ++j)
+            {
+                cache.put("key", "validator", std::vector<double>(16, i));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // One whole entry survives, and no temporary file is left behind
+    auto actual = std::vector<double>();
+    BOOST_TEST(cache.get("key", "validator", &actual));
+    BOOST_REQUIRE(actual.size() == 16);
+    BOOST_TEST((actual == std::vector<double>(16, actual[0])));
+    char **names = VSIReadDir("/vsimem/stats_cache_tests/b");
+    BOOST_TEST(CSLCount(names) == 1);
+    CSLDestroy(names);
+}
+
+BOOST_AUTO_TEST_CASE(validator_tracks_contents)
+{
+    const char *path = "/vsimem/stats_cache_tests/data.bin";
+    std::string before, after;
+
+    write_file(path, "1234");
+    BOOST_TEST(stats_cache::validator(path, &before));
+    write_file(path, "123456");
+    BOOST_TEST(stats_cache::validator(path, &after));
+    BOOST_TEST(before != after);
+    VSIUnlink(path);
+
+    BOOST_TEST(!stats_cache::validator("/vsimem/stats_cache_tests/missing.bin", &after));
+    BOOST_TEST(!stats_cache::validator("<VRTDataset/>", &after));
+}
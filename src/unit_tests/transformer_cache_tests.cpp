@@ -0,0 +1,116 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define BOOST_TEST_MODULE Transformer Cache Unit Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+
+#include <gdal.h>
+#include <cpl_conv.h>
+
+#include "transformer_cache.hpp"
+
+static std::string wkt_of(const char *user_input)
+{
+    auto srs = OSRNewSpatialReference(nullptr);
+    char *wkt = nullptr;
+    OSRSetFromUserInput(srs, user_input);
+    OSRExportToWkt(srs, &wkt);
+    auto retval = std::string(wkt);
+    CPLFree(wkt);
+    OSRDestroySpatialReference(srs);
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(init)
+{
+    GDALAllRegister();
+}
+
+BOOST_AUTO_TEST_CASE(checkout_reuses_transformations)
+{
+    transformer_cache cache(4);
+    auto wgs84 = wkt_of("epsg:4326");
+    auto mercator = wkt_of("epsg:3857");
+    transformer_cache::transformations_t first, second, third;
+
+    BOOST_TEST(cache.checkout(wgs84, mercator, &first));
+    BOOST_TEST(cache.checkout(wgs84, mercator, &second));
+    BOOST_TEST(first.first != second.first);
+    cache.checkin(wgs84, mercator, first);
+    cache.checkin(wgs84, mercator, second);
+    BOOST_TEST(cache.size() == 2);
+
+    BOOST_TEST(cache.checkout(wgs84, mercator, &third));
+    BOOST_TEST((third == first || third == second));
+    BOOST_TEST(cache.size() == 1);
+    cache.checkin(wgs84, mercator, third);
+}
+
+BOOST_AUTO_TEST_CASE(checkin_evicts_least_recently_used)
+{
+    transformer_cache cache(1);
+    auto wgs84 = wkt_of("epsg:4326");
+    auto mercator = wkt_of("epsg:3857");
+    auto utm = wkt_of("epsg:32617");
+    transformer_cache::transformations_t first, second, third;
+
+    BOOST_TEST(cache.checkout(wgs84, mercator, &first));
+    BOOST_TEST(cache.checkout(wgs84, utm, &second));
+    cache.checkin(wgs84, mercator, first);
+    cache.checkin(wgs84, utm, second);
+    BOOST_TEST(cache.size() == 1);
+
+    BOOST_TEST(cache.checkout(wgs84, utm, &third));
+    BOOST_TEST((third == second));
+    cache.checkin(wgs84, utm, third);
+}
+
+BOOST_AUTO_TEST_CASE(checkout_bad_crs)
+{
+    transformer_cache cache(4);
+    transformer_cache::transformations_t transformations;
+
+    fprintf(stderr, "────────────────────── BEGIN EXPECTED ERROR MESSAGES ─────────────\n");
+    BOOST_TEST(!cache.checkout("NOT A CRS", wkt_of("epsg:3857"), &transformations));
+    fprintf(stderr, "────────────────────── END EXPECTED ERROR MESSAGES ───────────────\n");
+    BOOST_TEST(cache.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(grid_transform_round_trip)
+{
+    transformer_cache cache(4);
+    auto wgs84 = wkt_of("epsg:4326");
+    auto mercator = wkt_of("epsg:3857");
+    double src_transform[6] = {-80.0, 0.001, 0, 41.0, 0, -0.001};
+    double dst_transform[6] = {-8905559.26, 100, 0, 5012341.95, 0, -100};
+    auto transformer = grid_transformer_t();
+
+    BOOST_TEST(cache.checkout(wgs84, mercator, &transformer.transformations));
+    BOOST_TEST(grid_transformer_init(&transformer, src_transform, dst_transform, transformer.transformations));
+
+    double x[1] = {500}, y[1] = {250}, z[1] = {0};
+    int success[1] = {0};
+    BOOST_TEST(grid_transform(&transformer, FALSE, 1, x, y, z, success));
+    BOOST_TEST(success[0]);
+    BOOST_TEST(grid_transform(&transformer, TRUE, 1, x, y, z, success));
+    BOOST_TEST(success[0]);
+    BOOST_CHECK_SMALL(x[0] - 500, 1e-6);
+    BOOST_CHECK_SMALL(y[0] - 250, 1e-6);
+
+    cache.checkin(wgs84, mercator, transformer.transformations);
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2019-2021 Azavea
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WORKER_POOL_HPP__
+#define __WORKER_POOL_HPP__
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+
+/*
+ * A fixed-size pool of threads that run tasks taken from a shared
+ * FIFO queue.  Tasks must not block waiting on other tasks submitted
+ * to the same pool, except through task_group::wait.
+ */
+class worker_pool
+{
+public:
+    typedef std::function<void()> task_t;
+
+    /*
+     * Constructor
+     *
+     * @param threads The number of worker threads (if zero, tasks
+     *                are run synchronously by submit)
+     */
+    explicit worker_pool(int threads)
+        : m_tasks(),
+          m_threads(),
+          m_lock(PTHREAD_MUTEX_INITIALIZER),
+          m_cond(PTHREAD_COND_INITIALIZER),
+          m_stop(false)
+    {
+        for (int i = 0; i < threads; ++i)
+        {
+            pthread_t thread;
+            if (pthread_create(&thread, nullptr, worker_pool::run, this) == 0)
+            {
+                m_threads.push_back(thread);
+            }
+        }
+    }
+
+    worker_pool(const worker_pool &rhs) = delete;
+    worker_pool &operator=(const worker_pool &rhs) = delete;
+
+    /*
+     * Destructor.  Tasks that have already been submitted are run to
+     * completion before the worker threads are joined.
+     */
+    ~worker_pool()
+    {
+        pthread_mutex_lock(&m_lock);
+        m_stop = true;
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_lock);
+
+        for (auto thread : m_threads)
+        {
+            pthread_join(thread, nullptr);
+        }
+        pthread_cond_destroy(&m_cond);
+        pthread_mutex_destroy(&m_lock);
+    }
+
+    /*
+     * The number of worker threads.
+     */
+    int size() const
+    {
+        return static_cast<int>(m_threads.size());
+    }
+
+    /*
+     * Queue a task.
+     *
+     * @param task The task to run
+     */
+    void submit(task_t task)
+    {
+        if (m_threads.empty())
+        {
+            task();
+            return;
+        }
+
+        pthread_mutex_lock(&m_lock);
+        m_tasks.push_back(std::move(task));
+        pthread_cond_signal(&m_cond);
+        pthread_mutex_unlock(&m_lock);
+    }
+
+private:
+    static void *run(void *arg)
+    {
+        auto self = static_cast<worker_pool *>(arg);
+
+        while (true)
+        {
+            pthread_mutex_lock(&self->m_lock);
+            while (self->m_tasks.empty() && !self->m_stop)
+            {
+                pthread_cond_wait(&self->m_cond, &self->m_lock);
+            }
+            if (self->m_tasks.empty())
+            {
+                pthread_mutex_unlock(&self->m_lock);
+                return nullptr;
+            }
+            auto task = std::move(self->m_tasks.front());
+            self->m_tasks.pop_front();
+            pthread_mutex_unlock(&self->m_lock);
+
+            task();
+        }
+    }
+
+    std::deque<task_t> m_tasks;
+    std::vector<pthread_t> m_threads;
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_cond;
+    bool m_stop;
+};
+
+/*
+ * A set of tasks, submitted to a worker_pool, whose completion can be
+ * waited for as a unit.  The tasks of a group are kept in the group
+ * until a worker (or the waiter) starts them, so wait may be called
+ * from one of the pool's own threads: the waiter runs the tasks that
+ * have not started yet itself instead of waiting for a free worker.
+ */
+class task_group
+{
+public:
+    task_group()
+        : m_state(std::make_shared<state>())
+    {
+    }
+
+    task_group(const task_group &rhs) = delete;
+    task_group &operator=(const task_group &rhs) = delete;
+
+    ~task_group()
+    {
+        wait();
+    }
+
+    /*
+     * Run a task as a member of this group.
+     *
+     * @param pool The pool to run the task on (if nullptr, the task is
+     *             run synchronously)
+     * @param task The task to run
+     */
+    void run(worker_pool *pool, worker_pool::task_t task)
+    {
+        if (pool == nullptr)
+        {
+            task();
+            return;
+        }
+
+        pthread_mutex_lock(&m_state->lock);
+        m_state->queued.push_back(std::move(task));
+        pthread_mutex_unlock(&m_state->lock);
+
+        // The worker holds the state, not the group, since the waiter
+        // may have run the task and destroyed the group by then
+        auto shared = m_state;
+        pool->submit([shared]() { shared->run_one(); });
+    }
+
+    /*
+     * Wait for every task in this group to complete, running those
+     * that no worker has started yet on the calling thread.
+     */
+    void wait()
+    {
+        while (m_state->run_one())
+        {
+        }
+
+        pthread_mutex_lock(&m_state->lock);
+        while (m_state->running > 0)
+        {
+            pthread_cond_wait(&m_state->cond, &m_state->lock);
+        }
+        pthread_mutex_unlock(&m_state->lock);
+    }
+
+private:
+    struct state
+    {
+        state()
+            : queued(),
+              running(0),
+              lock(PTHREAD_MUTEX_INITIALIZER),
+              cond(PTHREAD_COND_INITIALIZER)
+        {
+        }
+
+        ~state()
+        {
+            pthread_cond_destroy(&cond);
+            pthread_mutex_destroy(&lock);
+        }
+
+        /*
+         * Run the oldest task that has not been started.
+         *
+         * @return True if a task was run, false if none was left
+         */
+        bool run_one()
+        {
+            pthread_mutex_lock(&lock);
+            if (queued.empty())
+            {
+                pthread_mutex_unlock(&lock);
+                return false;
+            }
+            auto task = std::move(queued.front());
+            queued.pop_front();
+            ++running;
+            pthread_mutex_unlock(&lock);
+
+            task();
+
+            pthread_mutex_lock(&lock);
+            if (--running == 0)
+            {
+                pthread_cond_broadcast(&cond);
+            }
+            pthread_mutex_unlock(&lock);
+            return true;
+        }
+
+        std::deque<worker_pool::task_t> queued;
+        int running;
+        pthread_mutex_t lock;
+        pthread_cond_t cond;
+    };
+
+    std::shared_ptr<state> m_state;
+};
+
+#endif